@@ -0,0 +1,889 @@
+#include <algorithm>
+
+#include "bitset_clique.h"
+#include "bnb_checkpoint.h"
+#include "../Common/work_stealing_pool.h"
+
+using namespace std;
+
+void BitsetCliqueSearch::Run(const unordered_set<int>& initial_clique, chrono::steady_clock::time_point search_deadline, const BnBOptions& options,
+    BnBCheckpoint& search_checkpoint)
+{
+    int threads = options.threads;
+    coloring_mode = options.coloring;
+    pruning_bound = options.bound;
+    initial = vector<int>(initial_clique.begin(), initial_clique.end());
+    best_clique.clear();
+    best_size = max<int>(initial.size(), lower_bound);
+    deadline = search_deadline;
+    checkpoint = &search_checkpoint;
+    nodes = 0;
+    maxsat_prunes = 0;
+    stopped = false;
+    upper_bound = 0;
+    profile = BnBProfile();
+    run_clock.Start();
+
+    int width = options.fixed_width ? FixedWidth() : 0;
+    if (width > words)
+    {
+        Widen(width);
+    }
+    switch (width)
+    {
+    case 1:
+        Search<1>(threads);
+        break;
+    case 2:
+        Search<2>(threads);
+        break;
+    case 3:
+        Search<3>(threads);
+        break;
+    case 4:
+        Search<4>(threads);
+        break;
+    case 5:
+        Search<5>(threads);
+        break;
+    case 6:
+        Search<6>(threads);
+        break;
+    case 7:
+        Search<7>(threads);
+        break;
+    case 8:
+        Search<8>(threads);
+        break;
+    case 16:
+        Search<16>(threads);
+        break;
+    case 32:
+        Search<32>(threads);
+        break;
+    default:
+        Search<0>(threads);
+        break;
+    }
+    profile.search_seconds = run_clock.Seconds();
+}
+
+int BitsetCliqueSearch::FixedWidth() const
+{
+    if (words <= 8)
+    {
+        return max(words, 1);
+    }
+    int width = 1;
+    while (width < words)
+    {
+        width *= 2;
+    }
+    return width <= kMaxFixedWords ? width : 0;
+}
+
+void BitsetCliqueSearch::Widen(int new_words)
+{
+    vector<Word> widened((size_t)vertices * new_words, 0);
+    for (int i = 0; i < vertices; ++i)
+    {
+        copy(Row(i), Row(i) + words, &widened[(size_t)i * new_words]);
+    }
+    adjacency.swap(widened);
+    words = new_words;
+}
+
+template <int kWords>
+void BitsetCliqueSearch::Search(int threads)
+{
+    const int words = Width<kWords>();
+    const vector<BnBFrontierNode>& frontier = checkpoint->GetFrontier();
+    PrepareRoots();
+    if (threads <= 1)
+    {
+        SearchState state;
+        PrepareDepth(state, 0);
+        // the nodes left by the last run go on where it stopped
+        vector<int> clique;
+        vector<Word> node_candidates;
+        for (int i = 0; i < frontier.size(); ++i)
+        {
+            if (!checkpoint->IsFrontierOpen(i))
+            {
+                continue;
+            }
+            if (!FrontierTask(frontier[i], clique, node_candidates))
+            {
+                CompleteRoot(vertices + i);
+                continue;
+            }
+            int depth = clique.size() - 1;
+            PrepareDepth(state, depth);
+            Word* candidates = state.depth_candidates[depth].data();
+            int candidate_count = 0;
+            for (int w = 0; w < words; ++w)
+            {
+                candidates[w] = node_candidates[w];
+                candidate_count += PopCount(candidates[w]);
+            }
+            if (stopped || chrono::steady_clock::now() > deadline)
+            {
+                stopped = true;
+                RecordBound(RootBound<kWords>(state, depth));
+                continue;
+            }
+            state.root = vertices + i;
+            state.leave_depth = max(depth, kMaxSplitDepth);
+            state.clique = clique;
+            Expand<kWords>(state, depth, (int)clique.size() + candidate_count);
+            state.clique.clear();
+            CompleteRoot(vertices + i);
+        }
+        // the last bit is the first vertex of the pardalos order
+        state.leave_depth = kMaxSplitDepth;
+        for (int p = vertices - 1; p >= 0; --p)
+        {
+            if (!checkpoint->IsOpen(order[p]))
+            {
+                continue;
+            }
+            Word* candidates = state.depth_candidates[0].data();
+            TopLevelCandidates<kWords>(p, candidates);
+            if (stopped || chrono::steady_clock::now() > deadline)
+            {
+                // the rest of the top-level subtrees are only bounded
+                stopped = true;
+                RecordBound(RootBound<kWords>(state, 0));
+                continue;
+            }
+            int candidate_count = 0;
+            for (int w = 0; w < words; ++w)
+            {
+                candidate_count += PopCount(candidates[w]);
+            }
+            state.root = p;
+            state.clique.push_back(p);
+            Expand<kWords>(state, 0, 1 + candidate_count);
+            state.clique.pop_back();
+            CompleteRoot(p);
+        }
+        nodes = state.nodes;
+        maxsat_prunes = state.maxsat_prunes;
+        state.profile.AddThreadTime(run_clock.Seconds());
+        profile.Merge(state.profile);
+        return;
+    }
+
+    worker_states.assign(threads, SearchState());
+    {
+        WorkStealingPool workers(threads);
+        pool = &workers;
+        for (int i = 0; i < frontier.size(); ++i)
+        {
+            vector<int> clique;
+            vector<Word> candidates;
+            if (!checkpoint->IsFrontierOpen(i))
+            {
+                continue;
+            }
+            if (!FrontierTask(frontier[i], clique, candidates))
+            {
+                CompleteRoot(vertices + i);
+                continue;
+            }
+            StartRootTask(vertices + i);
+            workers.Submit([this, root = vertices + i, clique = move(clique), candidates = move(candidates)]
+                {
+                    RunTask<kWords>(root, -1, clique, candidates);
+                });
+        }
+        for (int p = vertices - 1; p >= 0; --p)
+        {
+            if (!checkpoint->IsOpen(order[p]))
+            {
+                continue;
+            }
+            StartRootTask(p);
+            workers.Submit([this, p]
+                {
+                    vector<Word> candidates(Width<kWords>());
+                    TopLevelCandidates<kWords>(p, candidates.data());
+                    RunTask<kWords>(p, -1, { p }, candidates);
+                });
+        }
+        workers.Wait();
+        pool = nullptr;
+    }
+    for (const auto& state : worker_states)
+    {
+        nodes += state.nodes;
+        maxsat_prunes += state.maxsat_prunes;
+        profile.Merge(state.profile);
+    }
+    worker_states.clear();
+}
+
+void BitsetCliqueSearch::SetLowerBound(int size)
+{
+    lower_bound = size;
+}
+
+unordered_set<int> BitsetCliqueSearch::GetClique()
+{
+    vector<int> clique = BestClique();
+    return unordered_set<int>(clique.begin(), clique.end());
+}
+
+vector<int> BitsetCliqueSearch::BestClique()
+{
+    lock_guard<mutex> lock(best_mutex);
+    if (best_clique.empty())
+    {
+        return initial;
+    }
+    vector<int> clique;
+    for (int p : best_clique)
+    {
+        clique.push_back(order[p]);
+    }
+    return clique;
+}
+
+long long BitsetCliqueSearch::GetNodes()
+{
+    return nodes;
+}
+
+long long BitsetCliqueSearch::GetMaxSatPrunes()
+{
+    return maxsat_prunes;
+}
+
+bool BitsetCliqueSearch::IsStopped()
+{
+    return stopped;
+}
+
+int BitsetCliqueSearch::GetUpperBound()
+{
+    return max<int>(upper_bound, best_size);
+}
+
+const BnBProfile& BitsetCliqueSearch::GetProfile()
+{
+    return profile;
+}
+
+void BitsetCliqueSearch::RecordBound(int bound)
+{
+    int current = upper_bound.load(memory_order_relaxed);
+    while (bound > current && !upper_bound.compare_exchange_weak(current, bound))
+    {
+    }
+}
+
+template <int kWords>
+int BitsetCliqueSearch::RootBound(SearchState& state, int depth)
+{
+    int colored = ColorCandidates<kWords>(state, state.depth_candidates[depth].data(), depth, 0, false);
+    return depth + 1 + (colored > 0 ? state.depth_colors[depth][colored - 1] : 0);
+}
+
+void BitsetCliqueSearch::PrepareRoots()
+{
+    int roots = vertices + checkpoint->GetFrontier().size();
+    root_tasks.assign(roots, 0);
+    root_skipped.assign(roots, false);
+    root_frontier.assign(roots, vector<BnBFrontierNode>());
+}
+
+bool BitsetCliqueSearch::FrontierTask(const BnBFrontierNode& node, vector<int>& clique, vector<Word>& candidates) const
+{
+    clique.clear();
+    for (int vertex : node.clique)
+    {
+        if (vertex >= position.size() || position[vertex] < 0)
+        {
+            return false;
+        }
+        clique.push_back(position[vertex]);
+    }
+    // candidates left out of the order can't be in a clique larger than the incumbent either
+    candidates.assign(words, 0);
+    for (int vertex : node.candidates)
+    {
+        int p = vertex < position.size() ? position[vertex] : -1;
+        if (p >= 0)
+        {
+            candidates[p / kWordBits] |= Word(1) << (p % kWordBits);
+        }
+    }
+    return true;
+}
+
+void BitsetCliqueSearch::LeaveOpen(int root, const vector<int>& clique, const Word* candidates)
+{
+    BnBFrontierNode node;
+    for (int p : clique)
+    {
+        node.clique.push_back(order[p]);
+    }
+    for (int w = 0; w < words; ++w)
+    {
+        for (Word bits = candidates[w]; bits != 0; bits &= bits - 1)
+        {
+            node.candidates.push_back(order[w * kWordBits + LowestBit(bits)]);
+        }
+    }
+    lock_guard<mutex> lock(root_mutex);
+    root_frontier[root].push_back(move(node));
+}
+
+void BitsetCliqueSearch::CompleteRoot(int root)
+{
+    vector<BnBFrontierNode> left;
+    {
+        lock_guard<mutex> lock(root_mutex);
+        left.swap(root_frontier[root]);
+    }
+    if (root < vertices)
+    {
+        checkpoint->Complete(order[root], BestClique(), left);
+    }
+    else
+    {
+        checkpoint->CompleteFrontier(root - vertices, BestClique(), left);
+    }
+}
+
+void BitsetCliqueSearch::StartRootTask(int root)
+{
+    lock_guard<mutex> lock(root_mutex);
+    ++root_tasks[root];
+}
+
+void BitsetCliqueSearch::FinishRootTask(int root, bool skipped)
+{
+    bool completed;
+    {
+        lock_guard<mutex> lock(root_mutex);
+        root_skipped[root] = root_skipped[root] || skipped;
+        completed = --root_tasks[root] == 0 && !root_skipped[root];
+    }
+    if (completed)
+    {
+        CompleteRoot(root);
+    }
+}
+
+void BitsetCliqueSearch::PrepareDepth(SearchState& state, int depth)
+{
+    // tasks can start deep in the tree, so every missing depth up to the requested one is added
+    while ((int)state.depth_candidates.size() <= depth)
+    {
+        state.depth_candidates.emplace_back(words * 3, 0);
+        state.depth_vertices.emplace_back(vertices, 0);
+        state.depth_colors.emplace_back(vertices, 0);
+    }
+}
+
+template <int kWords>
+void BitsetCliqueSearch::TopLevelCandidates(int p, Word* candidates)
+{
+    const int words = Width<kWords>();
+    const Word* row = Row<kWords>(p);
+    for (int w = 0; w < words; ++w)
+    {
+        candidates[w] = row[w];
+    }
+    // keep only the neighbours that come later in the pardalos order, i.e. lower bits
+    candidates[p / kWordBits] &= (Word(1) << (p % kWordBits)) - 1;
+    for (int w = p / kWordBits + 1; w < words; ++w)
+    {
+        candidates[w] = 0;
+    }
+}
+
+void BitsetCliqueSearch::UpdateBest(const vector<int>& clique)
+{
+    if ((int)clique.size() <= best_size.load(memory_order_relaxed))
+    {
+        return;
+    }
+    lock_guard<mutex> lock(best_mutex);
+    if ((int)clique.size() > best_size.load(memory_order_relaxed))
+    {
+        best_clique = clique;
+        best_size = clique.size();
+        profile.RecordIncumbent(run_clock.Seconds(), clique.size());
+    }
+}
+
+template <int kWords>
+int BitsetCliqueSearch::ColorCandidates(SearchState& state, const Word* candidates, int depth, int k_min, bool renumber)
+{
+    const int words = Width<kWords>();
+    Word* class_sets = nullptr;
+    if (k_min > 0)
+    {
+        if (state.class_sets.size() < (size_t)(k_min + 1) * words)
+        {
+            state.class_sets.resize((size_t)(k_min + 1) * words);
+        }
+        class_sets = state.class_sets.data();
+        fill(class_sets, class_sets + (size_t)(k_min + 1) * words, 0);
+    }
+
+    // the uncolored vertices and the vertices that can still get the current color. A fixed width keeps them
+    // on the stack, the dynamic kernel in the rest of the depth storage
+    Word stack_sets[kWords > 0 ? 2 * kWords : 1];
+    Word* uncolored = kWords > 0 ? stack_sets : state.depth_candidates[depth].data() + words;
+    Word* available = uncolored + words;
+    int* colored_vertices = state.depth_vertices[depth].data();
+    int* colors = state.depth_colors[depth].data();
+
+    int left = 0;
+    for (int w = 0; w < words; ++w)
+    {
+        uncolored[w] = candidates[w];
+        left += PopCount(candidates[w]);
+    }
+
+    int colored = 0;
+    int color = 0;
+    while (left > 0)
+    {
+        ++color;
+        for (int w = 0; w < words; ++w)
+        {
+            available[w] = uncolored[w];
+        }
+        // the vertices are taken in ascending bit order, every one of them closes its neighbours for this color.
+        // The word being scanned stays in a register, only the later ones are written back
+        for (int w = 0; w < words; ++w)
+        {
+            Word current = available[w];
+            while (current)
+            {
+                int vertex = w * kWordBits + LowestBit(current);
+                const Word* row = Row<kWords>(vertex);
+                current &= current - 1;
+                uncolored[w] &= ~(Word(1) << (vertex % kWordBits));
+                --left;
+                if (color > k_min && k_min > 0 && renumber && Renumber<kWords>(state, vertex, k_min))
+                {
+                    // the vertex went to an earlier class, so it does not close anything in this one
+                    continue;
+                }
+                current &= ~row[w];
+                for (int rest = w + 1; rest < words; ++rest)
+                {
+                    available[rest] &= ~row[rest];
+                }
+                if (color <= k_min)
+                {
+                    class_sets[(size_t)color * words + w] |= Word(1) << (vertex % kWordBits);
+                    continue;
+                }
+                colored_vertices[colored] = vertex;
+                colors[colored] = color;
+                ++colored;
+            }
+        }
+    }
+    return colored;
+}
+
+template <int kWords>
+bool BitsetCliqueSearch::Renumber(SearchState& state, int vertex, int k_min)
+{
+    const int words = Width<kWords>();
+    Word* class_sets = state.class_sets.data();
+    const Word* row = Row<kWords>(vertex);
+    for (int k1 = 1; k1 <= k_min; ++k1)
+    {
+        // the single neighbour of the vertex in class k1, if there is exactly one
+        const Word* first_class = class_sets + (size_t)k1 * words;
+        int moved = -1;
+        bool single = true;
+        for (int w = 0; w < words && single; ++w)
+        {
+            Word common = first_class[w] & row[w];
+            if (common == 0)
+            {
+                continue;
+            }
+            if (moved >= 0 || (common & (common - 1)) != 0)
+            {
+                single = false;
+                break;
+            }
+            moved = w * kWordBits + LowestBit(common);
+        }
+        if (!single || moved < 0)
+        {
+            continue;
+        }
+
+        const Word* moved_row = Row<kWords>(moved);
+        for (int k2 = 1; k2 <= k_min; ++k2)
+        {
+            if (k2 == k1)
+            {
+                continue;
+            }
+            const Word* second_class = class_sets + (size_t)k2 * words;
+            bool free = true;
+            for (int w = 0; w < words; ++w)
+            {
+                if (second_class[w] & moved_row[w])
+                {
+                    free = false;
+                    break;
+                }
+            }
+            if (free)
+            {
+                Word moved_bit = Word(1) << (moved % kWordBits);
+                class_sets[(size_t)k1 * words + moved / kWordBits] &= ~moved_bit;
+                class_sets[(size_t)k2 * words + moved / kWordBits] |= moved_bit;
+                class_sets[(size_t)k1 * words + vertex / kWordBits] |= Word(1) << (vertex % kWordBits);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template <int kWords>
+int BitsetCliqueSearch::PruneByMaxSat(SearchState& state, int depth, int colored, int k_min)
+{
+    const int words = Width<kWords>();
+    if (state.alive.size() < (size_t)(k_min + 1) * words)
+    {
+        state.alive.resize((size_t)(k_min + 1) * words);
+    }
+    state.class_state.assign(k_min + 1, kClassOpen);
+    int* colored_vertices = state.depth_vertices[depth].data();
+    int left = colored;
+    for (int i = 0; i < colored; ++i)
+    {
+        if (FailedVertex<kWords>(state, colored_vertices[i], k_min))
+        {
+            colored_vertices[i] = -1 - colored_vertices[i];
+            --left;
+        }
+    }
+    state.maxsat_prunes += colored - left;
+    return left;
+}
+
+template <int kWords>
+bool BitsetCliqueSearch::FailedVertex(SearchState& state, int vertex, int k_min)
+{
+    const int words = Width<kWords>();
+    const Word* class_sets = state.class_sets.data();
+    Word* alive = state.alive.data();
+    vector<int>& class_state = state.class_state;
+    vector<int>& unit_classes = state.unit_classes;
+    vector<int>& forced_vertices = state.forced_vertices;
+    vector<int>& forced_classes = state.forced_classes;
+    unit_classes.clear();
+    forced_vertices.clear();
+    forced_classes.clear();
+
+    // the vertex is in the clique, so its non-neighbours are out of every class
+    int conflict = -1;
+    const Word* row = Row<kWords>(vertex);
+    for (int c = 1; c <= k_min && conflict < 0; ++c)
+    {
+        if (class_state[c] == kClassUsed)
+        {
+            continue;
+        }
+        class_state[c] = kClassOpen;
+        Word* class_alive = &alive[(size_t)c * words];
+        const Word* members = &class_sets[(size_t)c * words];
+        int count = 0;
+        for (int w = 0; w < words; ++w)
+        {
+            class_alive[w] = members[w] & row[w];
+            count += class_alive[w] == 0 ? 0 : (class_alive[w] & (class_alive[w] - 1)) == 0 ? 1 : 2;
+        }
+        if (count == 0)
+        {
+            conflict = c;
+        }
+        else if (count == 1)
+        {
+            unit_classes.push_back(c);
+        }
+    }
+
+    // a class with a single vertex left puts it into the clique, its non-neighbours go out of the other classes
+    for (size_t next = 0; next < unit_classes.size() && conflict < 0; ++next)
+    {
+        int unit = unit_classes[next];
+        if (class_state[unit] != kClassOpen)
+        {
+            continue;
+        }
+        int forced = -1;
+        for (int w = 0; w < words; ++w)
+        {
+            if (alive[(size_t)unit * words + w])
+            {
+                forced = w * kWordBits + LowestBit(alive[(size_t)unit * words + w]);
+                break;
+            }
+        }
+        class_state[unit] = kClassFired;
+        forced_vertices.push_back(forced);
+        forced_classes.push_back(unit);
+        const Word* forced_row = Row<kWords>(forced);
+        for (int c = 1; c <= k_min && conflict < 0; ++c)
+        {
+            if (class_state[c] != kClassOpen)
+            {
+                continue;
+            }
+            Word* class_alive = &alive[(size_t)c * words];
+            int count = 0;
+            for (int w = 0; w < words; ++w)
+            {
+                class_alive[w] &= forced_row[w];
+                count += class_alive[w] == 0 ? 0 : (class_alive[w] & (class_alive[w] - 1)) == 0 ? 1 : 2;
+            }
+            if (count == 0)
+            {
+                conflict = c;
+            }
+            else if (count == 1)
+            {
+                unit_classes.push_back(c);
+            }
+        }
+    }
+    if (conflict < 0)
+    {
+        return false;
+    }
+
+    // only the classes the conflict depends on form the inconsistent subset: every vertex of a needed class
+    // was removed by the vertex itself or by the earliest forced vertex that isn't its neighbour
+    auto adjacent = [this](int u, int v)
+    {
+        return (Row<kWords>(u)[v / kWordBits] >> (v % kWordBits)) & 1;
+    };
+    class_state[conflict] = kClassNeeded;
+    unit_classes.clear();
+    unit_classes.push_back(conflict);
+    for (size_t next = 0; next < unit_classes.size(); ++next)
+    {
+        int c = unit_classes[next];
+        for (int w = 0; w < words; ++w)
+        {
+            Word members = class_sets[(size_t)c * words + w];
+            while (members)
+            {
+                int member = w * kWordBits + LowestBit(members);
+                members &= members - 1;
+                if (!adjacent(vertex, member))
+                {
+                    continue;
+                }
+                for (size_t j = 0; j < forced_vertices.size(); ++j)
+                {
+                    if (forced_vertices[j] != member && !adjacent(forced_vertices[j], member))
+                    {
+                        if (class_state[forced_classes[j]] == kClassFired)
+                        {
+                            class_state[forced_classes[j]] = kClassNeeded;
+                            unit_classes.push_back(forced_classes[j]);
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    for (int c = 1; c <= k_min; ++c)
+    {
+        if (class_state[c] == kClassNeeded)
+        {
+            class_state[c] = kClassUsed;
+        }
+    }
+    return true;
+}
+
+template <int kWords>
+void BitsetCliqueSearch::Expand(SearchState& state, int depth, int bound)
+{
+    const int words = Width<kWords>();
+    ++state.nodes;
+    state.profile.CountNode(depth);
+    // a cheap counter decides when to look at the clock
+    if ((state.nodes & (kDeadlineCheckNodes - 1)) == 0 && chrono::steady_clock::now() > deadline)
+    {
+        stopped = true;
+    }
+    Word* candidates = state.depth_candidates[depth].data();
+    if (stopped.load(memory_order_relaxed))
+    {
+        RecordBound(bound);
+        if (depth <= state.leave_depth)
+        {
+            LeaveOpen(state.root, state.clique, candidates);
+        }
+        return;
+    }
+
+    bool empty = true;
+    for (int w = 0; w < words; ++w)
+    {
+        if (candidates[w])
+        {
+            empty = false;
+            break;
+        }
+    }
+    if (empty)
+    {
+        UpdateBest(state.clique);
+        return;
+    }
+
+    PrepareDepth(state, depth + 1);
+    // the classes up to k_min can't raise the clique above the best one, they are never branched on
+    bool renumber = coloring_mode == ColoringMode::Renumber;
+    bool maxsat = pruning_bound == PruningBound::MaxSat;
+    int k_min = 0;
+    if (renumber || maxsat)
+    {
+        k_min = best_size.load(memory_order_relaxed) - (int)state.clique.size();
+    }
+    bool timed = state.profile.SamplesColoring(state.nodes);
+    ProfileClock coloring_clock;
+    if (timed)
+    {
+        coloring_clock.Start();
+    }
+    int colored = ColorCandidates<kWords>(state, candidates, depth, k_min, renumber);
+    if (timed)
+    {
+        state.profile.AddColoringSample(coloring_clock.Seconds());
+    }
+    int* colored_vertices = state.depth_vertices[depth].data();
+    const int* colors = state.depth_colors[depth].data();
+    // the coloring failed to cut the node off, the branching vertices left bound it together with the first k_min classes
+    maxsat = maxsat && k_min > 0 && colored > 0;
+    int branches = maxsat ? PruneByMaxSat<kWords>(state, depth, colored, k_min) : colored;
+    // the highest color of the vertices dropped by MaxSAT, they stay among the candidates
+    int top_pruned = 0;
+
+    for (int i = colored - 1; i >= 0; --i)
+    {
+        if (colored_vertices[i] < 0)
+        {
+            top_pruned = max(top_pruned, colors[i]);
+            continue;
+        }
+        int remaining_bound = max(colors[i], top_pruned);
+        if (maxsat)
+        {
+            remaining_bound = min(remaining_bound, k_min + branches);
+        }
+        if ((int)state.clique.size() + remaining_bound <= best_size.load(memory_order_relaxed))
+        {
+            // the vertices left have no higher colors, so none of them can beat the best clique
+            state.profile.CountColoringPrunes(i + 1);
+            return;
+        }
+        --branches;
+        int vertex = colored_vertices[i];
+        int child_bound = (int)state.clique.size() + remaining_bound;
+        const Word* row = Row<kWords>(vertex);
+        Word* new_candidates = state.depth_candidates[depth + 1].data();
+        for (int w = 0; w < words; ++w)
+        {
+            new_candidates[w] = candidates[w] & row[w];
+        }
+        state.clique.push_back(vertex);
+        if (pool != nullptr && depth < kMaxSplitDepth && pool->NeedsTasks())
+        {
+            // other threads are running out of work, so the child becomes a task of its own
+            StartRootTask(state.root);
+            pool->Submit([this, root = state.root, child_bound, clique = state.clique, child = vector<Word>(new_candidates, new_candidates + words)]
+                {
+                    RunTask<kWords>(root, child_bound, clique, child);
+                });
+        }
+        else
+        {
+            Expand<kWords>(state, depth + 1, child_bound);
+        }
+        state.clique.pop_back();
+        if (stopped.load(memory_order_relaxed))
+        {
+            // the child recorded its own bound, the siblings left are bounded by the next color down
+            if (maxsat)
+            {
+                RecordBound((int)state.clique.size() + min(remaining_bound, k_min + branches));
+            }
+            else if (i > 0)
+            {
+                RecordBound((int)state.clique.size() + colors[i - 1]);
+            }
+            // a child above leave_depth left its own nodes, a task is run or left by its worker, so the node keeps
+            // the candidates not branched on. At leave_depth the child's subtree stays in the node
+            if (depth < state.leave_depth)
+            {
+                candidates[vertex / kWordBits] &= ~(Word(1) << (vertex % kWordBits));
+            }
+            if (depth <= state.leave_depth)
+            {
+                LeaveOpen(state.root, state.clique, candidates);
+            }
+            return;
+        }
+        candidates[vertex / kWordBits] &= ~(Word(1) << (vertex % kWordBits));
+    }
+}
+
+template <int kWords>
+void BitsetCliqueSearch::RunTask(int root, int bound, const vector<int>& clique, const vector<Word>& candidates)
+{
+    const int words = Width<kWords>();
+    SearchState& state = worker_states[pool->CurrentWorker()];
+    ProfileClock task_clock;
+    task_clock.Start();
+    int depth = clique.size() - 1;
+    PrepareDepth(state, depth);
+    Word* target = state.depth_candidates[depth].data();
+    int candidate_count = 0;
+    for (int w = 0; w < words; ++w)
+    {
+        target[w] = candidates[w];
+        candidate_count += PopCount(candidates[w]);
+    }
+    if (stopped || chrono::steady_clock::now() > deadline)
+    {
+        stopped = true;
+        RecordBound(bound >= 0 ? bound : RootBound<kWords>(state, depth));
+        if (bound >= 0)
+        {
+            // the rest of the subproblem ran, this part of it is left to the checkpoint
+            LeaveOpen(root, clique, target);
+        }
+        FinishRootTask(root, bound < 0);
+        state.profile.AddThreadTime(task_clock.Seconds());
+        return;
+    }
+    state.root = root;
+    state.leave_depth = max(depth, kMaxSplitDepth);
+    state.clique = clique;
+    Expand<kWords>(state, depth, bound >= 0 ? bound : (int)clique.size() + candidate_count);
+    FinishRootTask(root, false);
+    state.profile.AddThreadTime(task_clock.Seconds());
+}
@@ -0,0 +1,262 @@
+#pragma once
+#include <vector>
+#include <unordered_set>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+#include "utils.h"
+#include "bnb_checkpoint.h"
+#include "../Common/bit_ops.h"
+#include "../Common/search_profile.h"
+
+class WorkStealingPool;
+
+// BBMC-style exact search: the graph is kept as an adjacency matrix of 64-bit words,
+// candidate sets are bitsets and child candidates are built with word-wise AND.
+// The search is compiled for every word count up to 8 and for 16 and 32 words, rows of the graphs in between are
+// padded with zero words. Word loops of these kernels have a constant trip count, graphs above 2048 vertices run
+// the kernel that reads the word count at runtime
+class BitsetCliqueSearch
+{
+public:
+    // vertices are renumbered so that bit i is order[i], coloring goes in ascending bit order. The order may leave
+    // vertices out, then the search runs on the subgraph of the ones in it. Graph is anything with size() and
+    // operator[] giving an iterable list of neighbours, like std::vector<std::unordered_set<int>> or CsrGraph
+    template <typename Graph>
+    void Init(const Graph& graph, const std::vector<int>& order);
+
+    // the search only looks for cliques larger than this, even if the initial clique is smaller.
+    // Used for subproblems whose clique is extended by vertices outside of them
+    void SetLowerBound(int size);
+
+    // the same top-level loop as BnBSolver::RunBnB: bit p is expanded together with its neighbours below p.
+    // With several threads the top-level vertices and the upper levels of their subtrees become tasks
+    // of a work-stealing pool, all of them prune against the shared best clique size.
+    // The frontier nodes of the checkpoint are searched first, then the top-level vertices open in it. Every one of
+    // them is reported to the checkpoint when its tasks are over, together with the nodes they left at the deadline
+    void Run(const std::unordered_set<int>& initial_clique, std::chrono::steady_clock::time_point deadline, const BnBOptions& options,
+        BnBCheckpoint& checkpoint);
+
+    // clique in the original numbering, the initial one if the search found nothing larger.
+    // The initial clique may use vertices left out of the order
+    std::unordered_set<int> GetClique();
+
+    long long GetNodes();
+
+    // branching vertices removed by the MaxSAT bound
+    long long GetMaxSatPrunes();
+
+    // true if the search stopped at the deadline before it was complete
+    bool IsStopped();
+
+    // no clique is larger than this: the best clique size or the largest coloring bound of the parts
+    // left unexplored at the deadline
+    int GetUpperBound();
+
+    // counters of the last Run merged from all its threads, the incumbents are seconds since Run started
+    const BnBProfile& GetProfile();
+
+private:
+    // everything a single thread changes during the search
+    struct SearchState
+    {
+        std::vector<int> clique;
+        // scratch storage of every depth, allocated once when the depth is reached for the first time
+        std::vector<std::vector<Word>> depth_candidates;
+        std::vector<std::vector<int>> depth_vertices;
+        std::vector<std::vector<int>> depth_colors;
+        // the first k_min color classes of the node being colored, used by Re-NUMBER
+        std::vector<Word> class_sets;
+        // MaxSAT reasoning: the vertices of every class left by unit propagation, the state of every class,
+        // the vertices set by unit propagation and their classes
+        std::vector<Word> alive;
+        std::vector<int> class_state;
+        std::vector<int> unit_classes;
+        std::vector<int> forced_vertices;
+        std::vector<int> forced_classes;
+        long long nodes = 0;
+        long long maxsat_prunes = 0;
+        BnBProfile profile;
+        // the subproblem being searched, see root_tasks
+        int root = 0;
+        // when the search stops, the nodes down to this depth leave what they didn't search to the checkpoint
+        int leave_depth = 0;
+    };
+
+    // subtrees are handed to other threads only this close to the root, and the nodes this close to it
+    // are kept in the checkpoint when the search stops
+    static const int kMaxSplitDepth = 6;
+
+    // the widest kernel with a word count known at compile time, 2048 vertices
+    static const int kMaxFixedWords = 32;
+
+    // the deadline is checked once per this many nodes of a thread, must be a power of two
+    static const long long kDeadlineCheckNodes = 1024;
+
+    // states of a color class in the MaxSAT reasoning of a node
+    enum ClassState
+    {
+        // not yet a unit
+        kClassOpen,
+        // propagated its single vertex
+        kClassFired,
+        // part of the inconsistent subset being collected
+        kClassNeeded,
+        // in an inconsistent subset found before, left out of the node
+        kClassUsed
+    };
+
+    int vertices = 0;
+    int words = 0;
+    std::vector<Word> adjacency;
+    std::vector<int> order;
+    // the bit of every vertex of the graph, -1 for the ones left out of the order
+    std::vector<int> position;
+    long long nodes = 0;
+    long long maxsat_prunes = 0;
+    // incumbents are recorded under best_mutex, the threads merge the rest at the end
+    BnBProfile profile;
+    ProfileClock run_clock;
+    ColoringMode coloring_mode = ColoringMode::Greedy;
+    PruningBound pruning_bound = PruningBound::Coloring;
+
+    int lower_bound = 0;
+    std::atomic<int> best_size{0};
+    std::atomic<bool> stopped{false};
+    std::atomic<int> upper_bound{0};
+    std::mutex best_mutex;
+    // bits of the best clique found by the search, empty until it beats the initial clique
+    std::vector<int> best_clique;
+    std::vector<int> initial;
+
+    WorkStealingPool* pool = nullptr;
+    std::vector<SearchState> worker_states;
+    std::chrono::steady_clock::time_point deadline;
+
+    // the subproblems are the top-level bits and, numbered from vertices on, the frontier nodes of the checkpoint.
+    // A subproblem is finished when the last of its tasks is, the nodes its tasks left at the deadline take its
+    // place in the checkpoint. One that was skipped at the deadline before it started stays open as it is
+    BnBCheckpoint* checkpoint = nullptr;
+    std::mutex root_mutex;
+    std::vector<int> root_tasks;
+    std::vector<bool> root_skipped;
+    std::vector<std::vector<BnBFrontierNode>> root_frontier;
+
+    // the word count of a kernel, kWords = 0 is the one that reads it at runtime
+    template <int kWords>
+    int Width() const
+    {
+        return kWords > 0 ? kWords : words;
+    }
+
+    template <int kWords = 0>
+    const Word* Row(int vertex) const
+    {
+        return &adjacency[(size_t)vertex * Width<kWords>()];
+    }
+
+    // the smallest fixed kernel width the graph fits in, 0 if it needs the dynamic kernel
+    int FixedWidth() const;
+
+    // pads every adjacency row with zero words up to the given word count
+    void Widen(int new_words);
+
+    // the top-level loop of Run on the kernel of the given width
+    template <int kWords>
+    void Search(int threads);
+
+    void PrepareDepth(SearchState& state, int depth);
+
+    // writes the top-level candidates of bit p, i.e. its neighbours with lower bits
+    template <int kWords>
+    void TopLevelCandidates(int p, Word* candidates);
+
+    void UpdateBest(const std::vector<int>& clique);
+
+    // the best clique so far in the original numbering
+    std::vector<int> BestClique();
+
+    // raises the upper bound to cover a part of the tree that is left unexplored
+    void RecordBound(int bound);
+
+    // depth + 1 + the number of colors of the candidates at the depth, a bound for a subproblem whose clique
+    // has depth + 1 vertices
+    template <int kWords>
+    int RootBound(SearchState& state, int depth);
+
+    // sizes the task counters and the frontier of the top-level bits and of the frontier nodes
+    void PrepareRoots();
+
+    // the clique and the candidates of a frontier node as bits, false if a vertex of its clique is not in the order.
+    // Such a node holds no clique larger than the incumbent
+    bool FrontierTask(const BnBFrontierNode& node, std::vector<int>& clique, std::vector<Word>& candidates) const;
+
+    // keeps the node with the clique and the candidates for the checkpoint, the search stopped before it was done
+    void LeaveOpen(int root, const std::vector<int>& clique, const Word* candidates);
+
+    // reports the subproblem to the checkpoint together with the current best clique and the nodes it left
+    void CompleteRoot(int root);
+
+    void StartRootTask(int root);
+
+    void FinishRootTask(int root, bool skipped);
+
+    // greedy sequential coloring of the candidates. Only the vertices with a color above k_min are written
+    // to the depth storage, their number is returned. The classes up to k_min are kept in state.class_sets
+    template <int kWords>
+    int ColorCandidates(SearchState& state, const Word* candidates, int depth, int k_min, bool renumber);
+
+    // Re-NUMBER: puts the vertex into a class k1 <= k_min by moving its only neighbour there to a class k2 <= k_min
+    template <int kWords>
+    bool Renumber(SearchState& state, int vertex, int k_min);
+
+    // the color classes up to k_min are soft clauses of a MaxSAT instance, at most one vertex of each is in a clique.
+    // A branching vertex is dropped, its depth entry becomes -1 - vertex, when unit propagation from it empties a class.
+    // The classes of every such inconsistent subset are left out of the later tests, so the subsets are disjoint and
+    // the candidates without the branching vertices left still hold no clique larger than k_min. Returns how many are left
+    template <int kWords>
+    int PruneByMaxSat(SearchState& state, int depth, int colored, int k_min);
+
+    // unit propagation from the vertex over the classes not used yet, marks the classes of the inconsistent
+    // subset used if it finds one
+    template <int kWords>
+    bool FailedVertex(SearchState& state, int vertex, int k_min);
+
+    // bound is the coloring bound of the node given by its parent, it is recorded if the node is cut off at the deadline
+    template <int kWords>
+    void Expand(SearchState& state, int depth, int bound);
+
+    // runs the subtree of the given clique and candidates on the calling worker, bound is -1 for the first task
+    // of a subproblem
+    template <int kWords>
+    void RunTask(int root, int bound, const std::vector<int>& clique, const std::vector<Word>& candidates);
+};
+
+template <typename Graph>
+void BitsetCliqueSearch::Init(const Graph& graph, const std::vector<int>& input_order)
+{
+    vertices = input_order.size();
+    words = WordsFor(vertices);
+    order = input_order;
+    adjacency.assign((size_t)vertices * words, 0);
+
+    // vertices left out of the order get no bit, edges to them are dropped
+    position.assign(graph.size(), -1);
+    for (int i = 0; i < vertices; ++i)
+    {
+        position[order[i]] = i;
+    }
+    for (int i = 0; i < vertices; ++i)
+    {
+        Word* row = &adjacency[(size_t)i * words];
+        for (int neighbour : graph[order[i]])
+        {
+            int j = position[neighbour];
+            if (j >= 0)
+            {
+                row[j / kWordBits] |= Word(1) << (j % kWordBits);
+            }
+        }
+    }
+}
@@ -0,0 +1,336 @@
+#include <fstream>
+#include <algorithm>
+#include <cstdio>
+
+#include "bnb_checkpoint.h"
+
+using namespace std;
+
+namespace
+{
+    // "<count> <vertex> ..." with every vertex below the given number of vertices
+    bool ReadVertices(istream& fin, int vertices, vector<int>& list)
+    {
+        int size;
+        if (!(fin >> size) || size < 0)
+        {
+            return false;
+        }
+        list.clear();
+        for (int i = 0; i < size; ++i)
+        {
+            int vertex;
+            if (!(fin >> vertex) || vertex < 0 || vertex >= vertices)
+            {
+                return false;
+            }
+            list.push_back(vertex);
+        }
+        return true;
+    }
+
+    void WriteVertices(ostream& fout, const vector<int>& list)
+    {
+        fout << list.size();
+        for (int vertex : list)
+        {
+            fout << " " << vertex;
+        }
+    }
+
+    // "node <clique> <candidates>" on a line of its own
+    void WriteNode(ostream& fout, const BnBFrontierNode& node)
+    {
+        fout << "node ";
+        WriteVertices(fout, node.clique);
+        fout << " ";
+        WriteVertices(fout, node.candidates);
+        fout << "\n";
+    }
+}
+
+BnBCheckpoint::BnBCheckpoint(const string& filename, double interval_seconds)
+    : filename(filename), interval_seconds(interval_seconds)
+{
+}
+
+bool BnBCheckpoint::Start(const CsrGraph& graph, const vector<int>& top_level_order)
+{
+    vertices = graph.size();
+    edges = graph.EdgeCount();
+    // FNV-1a over the top-level order and every row of the graph with its degree in front, so a file written
+    // for other edges or another order is only taken if the 64-bit hashes collide. Without a file it isn't needed
+    fingerprint = 14695981039346656037ull;
+    auto mix = [this](uint64_t value)
+    {
+        fingerprint = (fingerprint ^ value) * 1099511628211ull;
+    };
+    if (Enabled())
+    {
+        for (int vertex : top_level_order)
+        {
+            mix(vertex);
+        }
+        for (int v = 0; v < vertices; ++v)
+        {
+            mix(graph.offsets[v + 1] - graph.offsets[v]);
+            for (int neighbour : graph[v])
+            {
+                mix(neighbour);
+            }
+        }
+    }
+    open.assign(vertices, true);
+    open_count = vertices;
+    resumed.clear();
+    resumed_open.clear();
+    left_nodes.clear();
+    root_nodes.assign(vertices, 0);
+    frontier_roots = 0;
+    incumbent.clear();
+    previous_seconds = 0;
+    error.clear();
+    run_start = chrono::steady_clock::now();
+    last_save = run_start;
+    return Enabled() && Load();
+}
+
+bool BnBCheckpoint::Enabled() const
+{
+    return !filename.empty();
+}
+
+bool BnBCheckpoint::IsOpen(int vertex) const
+{
+    lock_guard<std::mutex> lock(mutex);
+    return open[vertex];
+}
+
+int BnBCheckpoint::GetOpenCount() const
+{
+    lock_guard<std::mutex> lock(mutex);
+    return open_count + frontier_roots;
+}
+
+const vector<BnBFrontierNode>& BnBCheckpoint::GetFrontier() const
+{
+    return resumed;
+}
+
+bool BnBCheckpoint::IsFrontierOpen(int index) const
+{
+    lock_guard<std::mutex> lock(mutex);
+    return resumed_open[index];
+}
+
+void BnBCheckpoint::ReopenFrontier()
+{
+    lock_guard<std::mutex> lock(mutex);
+    for (int i = 0; i < resumed.size(); ++i)
+    {
+        int root = resumed[i].clique[0];
+        if (resumed_open[i] && !open[root])
+        {
+            open[root] = true;
+            ++open_count;
+        }
+    }
+    resumed_open.assign(resumed.size(), false);
+    left_nodes.clear();
+    root_nodes.assign(vertices, 0);
+    frontier_roots = 0;
+}
+
+const vector<int>& BnBCheckpoint::GetIncumbent() const
+{
+    return incumbent;
+}
+
+double BnBCheckpoint::GetTotalSeconds() const
+{
+    return previous_seconds + chrono::duration<double>(chrono::steady_clock::now() - run_start).count();
+}
+
+string BnBCheckpoint::GetError() const
+{
+    lock_guard<std::mutex> lock(mutex);
+    return error;
+}
+
+void BnBCheckpoint::Complete(int vertex, const vector<int>& clique, const vector<BnBFrontierNode>& left)
+{
+    lock_guard<std::mutex> lock(mutex);
+    if (open[vertex])
+    {
+        open[vertex] = false;
+        --open_count;
+    }
+    AddNodes(left);
+    SaveIfDue(clique);
+}
+
+void BnBCheckpoint::CompleteFrontier(int index, const vector<int>& clique, const vector<BnBFrontierNode>& left)
+{
+    lock_guard<std::mutex> lock(mutex);
+    if (resumed_open[index])
+    {
+        resumed_open[index] = false;
+        RemoveNode(resumed[index].clique[0]);
+    }
+    AddNodes(left);
+    SaveIfDue(clique);
+}
+
+void BnBCheckpoint::AddNodes(const vector<BnBFrontierNode>& nodes)
+{
+    for (const auto& node : nodes)
+    {
+        left_nodes.push_back(node);
+        if (root_nodes[node.clique[0]]++ == 0)
+        {
+            ++frontier_roots;
+        }
+    }
+}
+
+void BnBCheckpoint::RemoveNode(int root)
+{
+    if (--root_nodes[root] == 0)
+    {
+        --frontier_roots;
+    }
+}
+
+void BnBCheckpoint::SaveIfDue(const vector<int>& clique)
+{
+    auto now = chrono::steady_clock::now();
+    if (Enabled() && chrono::duration<double>(now - last_save).count() >= interval_seconds)
+    {
+        Write(clique);
+        last_save = now;
+    }
+}
+
+void BnBCheckpoint::Save(const vector<int>& clique)
+{
+    lock_guard<std::mutex> lock(mutex);
+    if (Enabled())
+    {
+        Write(clique);
+        last_save = chrono::steady_clock::now();
+    }
+}
+
+bool BnBCheckpoint::Load()
+{
+    ifstream fin(filename);
+    if (!fin.is_open())
+    {
+        return false;
+    }
+    string word;
+    int file_vertices;
+    size_t file_edges;
+    uint64_t file_fingerprint;
+    fin >> word;
+    if (word != "bnb-checkpoint" || !(fin >> word >> file_vertices >> file_edges >> file_fingerprint) || word != "graph")
+    {
+        error = "Can't read checkpoint file " + filename + ", starting from scratch";
+        return false;
+    }
+    if (file_vertices != vertices || file_edges != edges || file_fingerprint != fingerprint)
+    {
+        error = "Checkpoint file " + filename + " was written for another graph, starting from scratch";
+        return false;
+    }
+
+    double seconds;
+    vector<int> clique;
+    vector<int> open_vertices;
+    vector<BnBFrontierNode> nodes;
+    bool ok = (fin >> word >> seconds) && word == "seconds";
+    ok = ok && (fin >> word) && word == "incumbent" && ReadVertices(fin, vertices, clique);
+    ok = ok && (fin >> word) && word == "open" && ReadVertices(fin, vertices, open_vertices);
+    // files written before the frontier was kept end here
+    int node_count = 0;
+    if (ok && (fin >> word))
+    {
+        ok = word == "frontier" && (fin >> node_count) && node_count >= 0;
+    }
+    for (int i = 0; ok && i < node_count; ++i)
+    {
+        BnBFrontierNode node;
+        ok = (fin >> word) && word == "node" && ReadVertices(fin, vertices, node.clique) && !node.clique.empty()
+            && ReadVertices(fin, vertices, node.candidates);
+        nodes.push_back(move(node));
+    }
+    if (!ok)
+    {
+        error = "Can't read checkpoint file " + filename + ", starting from scratch";
+        return false;
+    }
+
+    previous_seconds = seconds;
+    incumbent = clique;
+    open.assign(vertices, false);
+    for (int vertex : open_vertices)
+    {
+        open[vertex] = true;
+    }
+    open_count = open_vertices.size();
+    resumed = move(nodes);
+    resumed_open.assign(resumed.size(), true);
+    for (const auto& node : resumed)
+    {
+        if (root_nodes[node.clique[0]]++ == 0)
+        {
+            ++frontier_roots;
+        }
+    }
+    return true;
+}
+
+void BnBCheckpoint::Write(const vector<int>& clique)
+{
+    // the new file replaces the old one only when it is complete, so a crash while writing keeps the old one
+    string temporary = filename + ".tmp";
+    {
+        ofstream fout(temporary);
+        fout << "bnb-checkpoint\n";
+        fout << "graph " << vertices << " " << edges << " " << fingerprint << "\n";
+        fout << "seconds " << GetTotalSeconds() << "\n";
+        fout << "incumbent ";
+        WriteVertices(fout, clique);
+        fout << "\nopen " << open_count;
+        for (int vertex = 0; vertex < vertices; ++vertex)
+        {
+            if (open[vertex])
+            {
+                fout << " " << vertex;
+            }
+        }
+        fout << "\nfrontier " << count(resumed_open.begin(), resumed_open.end(), true) + left_nodes.size() << "\n";
+        for (int i = 0; i < resumed.size(); ++i)
+        {
+            if (resumed_open[i])
+            {
+                WriteNode(fout, resumed[i]);
+            }
+        }
+        for (const auto& node : left_nodes)
+        {
+            WriteNode(fout, node);
+        }
+        if (!fout)
+        {
+            error = "Can't write checkpoint file " + temporary;
+            return;
+        }
+    }
+    if (rename(temporary.c_str(), filename.c_str()) != 0)
+    {
+        // rename doesn't replace an existing file on Windows
+        remove(filename.c_str());
+        rename(temporary.c_str(), filename.c_str());
+    }
+}
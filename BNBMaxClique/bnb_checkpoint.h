@@ -0,0 +1,103 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+#include "../Common/dimacs_loader.h"
+
+// a part of a top-level subproblem that a search left when it stopped: a clique and the candidates that can still
+// extend it, in the numbering of the graph. The first vertex of the clique is the one of the top-level subproblem
+struct BnBFrontierNode
+{
+    std::vector<int> clique;
+    std::vector<int> candidates;
+};
+
+// progress of an exact search kept on disk. The search is split into top-level subproblems, one per vertex of the
+// top-level order: the vertex with its neighbours that come later in the order. The file holds the subproblems that
+// are not finished yet, the frontier nodes left of the ones a search stopped in, the incumbent clique and the seconds
+// spent on the search, so a later run on the same graph can go on from there. Subproblems and nodes that were running
+// when the file was written in the middle of a run are run again from the start
+class BnBCheckpoint
+{
+public:
+    // an empty filename disables the checkpoint, then every subproblem is open and nothing is written
+    BnBCheckpoint(const std::string& filename, double interval_seconds);
+
+    // reads the file if it exists and was written for the same graph and the same top-level order,
+    // starts the clock of this run. Returns true if the search resumes from the file
+    bool Start(const CsrGraph& graph, const std::vector<int>& top_level_order);
+
+    bool Enabled() const;
+
+    bool IsOpen(int vertex) const;
+
+    // top-level subproblems that are not finished, the open ones and the ones with frontier nodes left
+    int GetOpenCount() const;
+
+    // the frontier nodes read from the file, a search resumes them before the open top-level subproblems
+    const std::vector<BnBFrontierNode>& GetFrontier() const;
+
+    bool IsFrontierOpen(int index) const;
+
+    // opens the top-level subproblem of every frontier node again and drops the nodes, for a search that can't
+    // resume them
+    void ReopenFrontier();
+
+    // the incumbent read from the file, empty if the search didn't resume
+    const std::vector<int>& GetIncumbent() const;
+
+    // seconds spent by the earlier runs and by this one so far
+    double GetTotalSeconds() const;
+
+    // why the file couldn't be read or written the last time, empty if nothing went wrong
+    std::string GetError() const;
+
+    // marks the subproblem of the vertex finished and saves the file if the interval has passed since the last save.
+    // A search that stopped in it passes the nodes it left, they take its place. Can be called from several threads
+    void Complete(int vertex, const std::vector<int>& incumbent,
+        const std::vector<BnBFrontierNode>& left = std::vector<BnBFrontierNode>());
+
+    // the same for a frontier node read from the file
+    void CompleteFrontier(int index, const std::vector<int>& incumbent,
+        const std::vector<BnBFrontierNode>& left = std::vector<BnBFrontierNode>());
+
+    // saves the file right away, called when the search stops
+    void Save(const std::vector<int>& incumbent);
+
+private:
+    std::string filename;
+    double interval_seconds;
+    int vertices = 0;
+    size_t edges = 0;
+    std::uint64_t fingerprint = 0;
+    std::vector<bool> open;
+    int open_count = 0;
+    // the nodes read from the file and the ones left in this run, the open ones go to the file. Every top-level
+    // vertex counts its open nodes, frontier_roots is the number of vertices that have some
+    std::vector<BnBFrontierNode> resumed;
+    std::vector<bool> resumed_open;
+    std::vector<BnBFrontierNode> left_nodes;
+    std::vector<int> root_nodes;
+    int frontier_roots = 0;
+    std::vector<int> incumbent;
+    double previous_seconds = 0;
+    std::chrono::steady_clock::time_point run_start;
+    std::chrono::steady_clock::time_point last_save;
+    std::string error;
+    mutable std::mutex mutex;
+
+    bool Load();
+
+    // the caller holds the mutex
+    void AddNodes(const std::vector<BnBFrontierNode>& nodes);
+
+    void RemoveNode(int root);
+
+    void SaveIfDue(const std::vector<int>& clique);
+
+    // the caller holds the mutex
+    void Write(const std::vector<int>& clique);
+};
@@ -0,0 +1,439 @@
+#include <sstream>
+#include <algorithm>
+
+#include "bnb_solver.h"
+#include "bitset_clique.h"
+#include "sparse_clique.h"
+
+using namespace std;
+
+// set by CountAllocationsWith, shared by all the solvers of the program
+static const atomic<long long>* allocation_counter = nullptr;
+
+static long long CountedAllocations()
+{
+    return allocation_counter != nullptr ? allocation_counter->load() : 0;
+}
+
+BnBSolver::BnBSolver(const GraphHandle& graph, bool sparse_mode) : graph(graph), sparse(sparse_mode)
+{
+    if (!sparse)
+    {
+        search_neighbours = &graph.NeighbourSets();
+    }
+}
+
+void BnBSolver::CountAllocationsWith(const atomic<long long>* counter)
+{
+    allocation_counter = counter;
+}
+
+tuple<double, double> BnBSolver::RunBnB(double time_limit, const BnBOptions& options)
+{
+    auto start = chrono::steady_clock::now();
+    deadline = start + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(time_limit));
+    profile = BnBProfile();
+    run_clock.Start();
+    resumed_subproblems = -1;
+    checkpoint_error.clear();
+    if (sparse)
+    {
+        return RunSparse(start, options);
+    }
+    if (!heuristic)
+    {
+        heuristic = make_unique<MaxCliqueTabuSearch>(graph);
+    }
+    heuristic->SetSeed(options.seed);
+    heuristic->RunSearch(1000);
+    best_clique = heuristic->GetClique();
+    auto heuristic_finish = chrono::steady_clock::now();
+    double heuristic_seconds = chrono::duration<double>(heuristic_finish - start).count();
+
+    nodes = 0;
+    maxsat_prunes = 0;
+    coloring_mode = options.coloring;
+    const DegeneracyOrder& degeneracy = graph.Degeneracy();
+    const vector<int>& pardalos = degeneracy.order;
+    BnBCheckpoint checkpoint(options.checkpoint_file, options.checkpoint_interval);
+    if (checkpoint.Start(graph.Csr(), pardalos))
+    {
+        resumed_subproblems = checkpoint.GetOpenCount();
+    }
+    if (options.engine == BnBEngine::HashSets)
+    {
+        // the hash-set recursion only runs whole top-level subproblems, the ones a bitset run stopped in start over
+        checkpoint.ReopenFrontier();
+    }
+    if (checkpoint.GetIncumbent().size() > best_clique.size())
+    {
+        best_clique = unordered_set<int>(checkpoint.GetIncumbent().begin(), checkpoint.GetIncumbent().end());
+    }
+    profile.RecordIncumbent(heuristic_seconds, best_clique.size());
+
+    // only a kernel of the graph can hold a clique larger than the incumbent, the search runs on it in the
+    // pardalos order of the whole graph, so the top-level subproblems stay the ones of the checkpoint
+    search_graph = ReduceForClique(graph.NeighbourSets(), best_clique.size());
+    search_neighbours = search_graph.neighbour_sets.empty() ? &graph.NeighbourSets() : &search_graph.neighbour_sets;
+    reduced_vertices = search_graph.vertices.size();
+    reduced_edges = search_graph.edges;
+    vector<int> kernel_order;
+    kernel_order.reserve(search_graph.vertices.size());
+    vector<int> incumbent(best_clique.begin(), best_clique.end());
+    vector<bool> in_kernel(graph.size(), false);
+    for (int vertex : search_graph.vertices)
+    {
+        in_kernel[vertex] = true;
+    }
+    for (int vertex : pardalos)
+    {
+        if (in_kernel[vertex])
+        {
+            kernel_order.push_back(vertex);
+        }
+        else if (checkpoint.IsOpen(vertex))
+        {
+            checkpoint.Complete(vertex, incumbent);
+        }
+    }
+
+    if (options.engine == BnBEngine::Bitset)
+    {
+        BitsetCliqueSearch search;
+        // the bitset engine expands the last bit first
+        search.Init(*search_neighbours, vector<int>(kernel_order.rbegin(), kernel_order.rend()));
+        long long allocations_before = CountedAllocations();
+        search.Run(best_clique, deadline, options, checkpoint);
+        search_allocations = CountedAllocations() - allocations_before;
+        best_clique = search.GetClique();
+        nodes = search.GetNodes();
+        maxsat_prunes = search.GetMaxSatPrunes();
+        stopped = search.IsStopped();
+        upper_bound = search.GetUpperBound();
+        const BnBProfile& search_profile = search.GetProfile();
+        profile.Merge(search_profile);
+        for (const ProfileEvent& event : search_profile.incumbents)
+        {
+            profile.RecordIncumbent(heuristic_seconds + event.seconds, event.quality);
+        }
+        LimitUpperBound(kernel_order);
+        FinishCheckpoint(checkpoint);
+        auto finish = chrono::steady_clock::now();
+        profile.search_seconds = chrono::duration<double>(finish - heuristic_finish).count();
+        return make_tuple(heuristic_seconds, profile.search_seconds);
+    }
+
+    PrepareSearch(degeneracy.degeneracy);
+    stopped = false;
+    upper_bound = 0;
+    long long allocations_before = CountedAllocations();
+    for (int i = 0; i < kernel_order.size(); ++i)
+    {
+        int vertex = kernel_order[i];
+        if (!checkpoint.IsOpen(vertex))
+        {
+            continue;
+        }
+
+        vector<int>& new_candidates = depth_scratch[0].candidates;
+        new_candidates.clear();
+        for (int j = kernel_order.size() - 1; j > i; --j)
+        {
+            if ((*search_neighbours)[vertex].count(kernel_order[j]))
+            {
+                new_candidates.push_back(kernel_order[j]);
+            }
+        }
+        if (stopped || chrono::steady_clock::now() > deadline)
+        {
+            // the rest of the top-level subtrees are only bounded by the coloring of their candidates
+            stopped = true;
+            DepthScratch& scratch = depth_scratch[0];
+            ColorForBranching(*search_neighbours, new_candidates, 0, false, coloring_scratch, scratch.branch_vertices, scratch.branch_colors);
+            upper_bound = max(upper_bound, 1 + (scratch.branch_colors.empty() ? 0 : scratch.branch_colors.back()));
+            continue;
+        }
+        clique.push_back(vertex);
+        BnBRecursion(0, 1 + (int)new_candidates.size());
+        clique.pop_back();
+        if (!stopped)
+        {
+            checkpoint.Complete(vertex, best_vertices);
+        }
+    }
+    search_allocations = CountedAllocations() - allocations_before;
+    best_clique = unordered_set<int>(best_vertices.begin(), best_vertices.end());
+    upper_bound = max<int>(upper_bound, best_clique.size());
+    LimitUpperBound(kernel_order);
+    FinishCheckpoint(checkpoint);
+    auto finish = chrono::steady_clock::now();
+    profile.search_seconds = chrono::duration<double>(finish - heuristic_finish).count();
+    profile.AddThreadTime(profile.search_seconds);
+    return make_tuple(heuristic_seconds, profile.search_seconds);
+}
+
+const unordered_set<int>& BnBSolver::GetClique()
+{
+    return best_clique;
+}
+
+long long BnBSolver::GetNodes()
+{
+    return nodes;
+}
+
+long long BnBSolver::GetMaxSatPrunes()
+{
+    return maxsat_prunes;
+}
+
+int BnBSolver::GetReducedVertices()
+{
+    return reduced_vertices;
+}
+
+size_t BnBSolver::GetReducedEdges()
+{
+    return reduced_edges;
+}
+
+int BnBSolver::GetUpperBound()
+{
+    return upper_bound;
+}
+
+bool BnBSolver::IsOptimal()
+{
+    return upper_bound <= best_clique.size();
+}
+
+string BnBSolver::GetStatus()
+{
+    return IsOptimal() ? "optimal" : "timeout-with-gap";
+}
+
+double BnBSolver::GetTotalBnBTime()
+{
+    return total_bnb_time;
+}
+
+int BnBSolver::GetOpenSubproblems()
+{
+    return open_subproblems;
+}
+
+int BnBSolver::GetResumedSubproblems()
+{
+    return resumed_subproblems;
+}
+
+string BnBSolver::GetCheckpointError()
+{
+    return checkpoint_error;
+}
+
+int BnBSolver::GetSparseSubproblems()
+{
+    return sparse_subproblems;
+}
+
+long long BnBSolver::GetSearchAllocations()
+{
+    return search_allocations;
+}
+
+const BnBProfile& BnBSolver::GetProfile()
+{
+    return profile;
+}
+
+bool BnBSolver::Check()
+{
+    for (int i : best_clique)
+    {
+        for (int j : best_clique)
+        {
+            if (i != j && !graph.IsAdjacent(i, j))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+string BnBSolver::PrintClique()
+{
+    vector<int> clique;
+    clique.insert(clique.end(), best_clique.begin(), best_clique.end());
+    sort(clique.begin(), clique.end());
+    stringstream ss;
+    ss << "\"";
+    bool first_vertex = true;
+    ss << "{";
+    for (const auto& vertex : clique)
+    {
+        if (!first_vertex)
+        {
+            ss << ",";
+        }
+        ss << vertex;
+        first_vertex = false;
+    }
+    ss << "}";
+    ss << "\"";
+    return ss.str();
+}
+
+tuple<double, double> BnBSolver::RunSparse(chrono::steady_clock::time_point start, const BnBOptions& options)
+{
+    SparseCliqueSearch search(graph.Csr());
+    search.FindInitialClique();
+    auto heuristic_finish = chrono::steady_clock::now();
+    double heuristic_seconds = chrono::duration<double>(heuristic_finish - start).count();
+    profile.RecordIncumbent(heuristic_seconds, search.GetClique().size());
+    long long allocations_before = CountedAllocations();
+    search.Run(deadline, options);
+    search_allocations = CountedAllocations() - allocations_before;
+    best_clique = unordered_set<int>(search.GetClique().begin(), search.GetClique().end());
+    nodes = search.GetNodes();
+    maxsat_prunes = search.GetMaxSatPrunes();
+    stopped = search.IsStopped();
+    upper_bound = search.GetUpperBound();
+    reduced_vertices = search.GetCoreVertices();
+    reduced_edges = search.GetCoreEdges();
+    const BnBProfile& search_profile = search.GetProfile();
+    profile.Merge(search_profile);
+    for (const ProfileEvent& event : search_profile.incumbents)
+    {
+        profile.RecordIncumbent(heuristic_seconds + event.seconds, event.quality);
+    }
+    sparse_subproblems = search.GetSubproblems();
+    auto finish = chrono::steady_clock::now();
+    total_bnb_time = chrono::duration<double>(finish - heuristic_finish).count();
+    profile.search_seconds = total_bnb_time;
+    open_subproblems = search.GetOpenSubproblems();
+    return make_tuple(heuristic_seconds, total_bnb_time);
+}
+
+void BnBSolver::LimitUpperBound(const vector<int>& kernel_order)
+{
+    if (!stopped)
+    {
+        return;
+    }
+    ColoringScratch scratch;
+    scratch.Init(graph.size());
+    vector<int> branch_vertices;
+    vector<int> branch_colors;
+    ColorForBranching(*search_neighbours, vector<int>(kernel_order.rbegin(), kernel_order.rend()), 0, false, scratch, branch_vertices, branch_colors);
+    int colors = branch_colors.empty() ? 0 : branch_colors.back();
+    upper_bound = max<int>(min(upper_bound, colors), best_clique.size());
+}
+
+void BnBSolver::FinishCheckpoint(BnBCheckpoint& checkpoint)
+{
+    checkpoint.Save(vector<int>(best_clique.begin(), best_clique.end()));
+    total_bnb_time = checkpoint.GetTotalSeconds();
+    open_subproblems = checkpoint.GetOpenCount();
+    checkpoint_error = checkpoint.GetError();
+}
+
+void BnBSolver::PrepareSearch(int degeneracy)
+{
+    int vertices = graph.size();
+    depth_scratch.resize(degeneracy + 2);
+    for (auto& scratch : depth_scratch)
+    {
+        scratch.candidates.reserve(vertices);
+        scratch.branch_vertices.reserve(vertices);
+        scratch.branch_colors.reserve(vertices);
+    }
+    coloring_scratch.Init(vertices);
+    visit_stamp.assign(vertices, 0);
+    clique.clear();
+    clique.reserve(degeneracy + 1);
+    best_vertices.reserve(max<size_t>(degeneracy + 1, best_clique.size()));
+    best_vertices.assign(best_clique.begin(), best_clique.end());
+    // the depth and every improvement of the clique are bounded by the degeneracy + 1, so the profile doesn't
+    // allocate in the search either
+    profile.Reserve(degeneracy + 1, degeneracy + 1);
+}
+
+void BnBSolver::BnBRecursion(int depth, int bound)
+{
+    // the node number marks the candidates already branched on in this node
+    long long stamp = ++nodes;
+    profile.CountNode(depth);
+    // a cheap counter decides when to look at the clock
+    if ((stamp & (kDeadlineCheckNodes - 1)) == 0 && chrono::steady_clock::now() > deadline)
+    {
+        stopped = true;
+    }
+    if (stopped)
+    {
+        upper_bound = max(upper_bound, bound);
+        return;
+    }
+    DepthScratch& scratch = depth_scratch[depth];
+    const vector<int>& candidates = scratch.candidates;
+    if (candidates.empty())
+    {
+        if (clique.size() > best_vertices.size())
+        {
+            best_vertices = clique;
+            profile.RecordIncumbent(run_clock.Seconds(), clique.size());
+        }
+        return;
+    }
+
+    // vertices to branch on grouped by ascending color, inside a class in antipardalos order
+    bool renumber = coloring_mode == ColoringMode::Renumber;
+    int k_min = renumber ? (int)best_vertices.size() - (int)clique.size() : 0;
+    bool timed = profile.SamplesColoring(stamp);
+    ProfileClock coloring_clock;
+    if (timed)
+    {
+        coloring_clock.Start();
+    }
+    ColorForBranching(*search_neighbours, candidates, k_min, renumber, coloring_scratch, scratch.branch_vertices, scratch.branch_colors);
+    if (timed)
+    {
+        profile.AddColoringSample(coloring_clock.Seconds());
+    }
+
+    vector<int>& new_candidates = depth_scratch[depth + 1].candidates;
+    //traverse from the largest color, inside a class in pardalos order
+    for (int i = scratch.branch_vertices.size() - 1; i >= 0; --i)
+    {
+        if (clique.size() + scratch.branch_colors[i] <= best_vertices.size())
+        {
+            profile.CountColoringPrunes(i + 1);
+            return;
+        }
+
+        int vertex_to_add = scratch.branch_vertices[i];
+        visit_stamp[vertex_to_add] = stamp;
+
+        new_candidates.clear();
+        for (int candidate : candidates)
+        {
+            if (visit_stamp[candidate] != stamp && (*search_neighbours)[vertex_to_add].count(candidate))
+            {
+                new_candidates.push_back(candidate);
+            }
+        }
+        clique.push_back(vertex_to_add);
+        BnBRecursion(depth + 1, (int)clique.size() - 1 + scratch.branch_colors[i]);
+        clique.pop_back();
+        if (stopped)
+        {
+            // the child kept its own bound, the siblings left are bounded by the next color down
+            if (i > 0)
+            {
+                upper_bound = max<int>(upper_bound, clique.size() + scratch.branch_colors[i - 1]);
+            }
+            return;
+        }
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include <vector>
+#include <unordered_set>
+#include <string>
+#include <tuple>
+#include <memory>
+#include <atomic>
+#include <chrono>
+
+#include "utils.h"
+#include "bnb_checkpoint.h"
+#include "../Common/graph_handle.h"
+#include "../Common/search_profile.h"
+#include "../TabuMaxClique/tabu_max_clique.h"
+
+// exact search for a maximum clique. The dense mode starts from a tabu search clique, reduces the graph to the
+// kernel that can hold a larger one and searches it with the hash-set or the bitset engine. The sparse mode runs
+// SparseCliqueSearch on graphs with millions of vertices
+class BnBSolver
+{
+public:
+    // the sparse mode works on the CSR rows of the graph only, the dense one on its neighbour sets
+    explicit BnBSolver(const GraphHandle& graph, bool sparse_mode = false);
+
+    // the search counts its heap allocations with this counter, a program that counts them in its operator new
+    // sets it once. GetSearchAllocations is 0 without it
+    static void CountAllocationsWith(const std::atomic<long long>* counter);
+
+    // returns the wall-clock seconds of the heuristic and of the exact search, the time limit covers both.
+    // With a checkpoint file the search goes on from it and keeps it up to date
+    std::tuple<double, double> RunBnB(double time_limit, const BnBOptions& options = BnBOptions());
+
+    const std::unordered_set<int>& GetClique();
+
+    long long GetNodes();
+
+    // branching vertices the MaxSAT bound removed, the bitset engine only
+    long long GetMaxSatPrunes();
+
+    // size of the kernel the last exact search ran on, in the sparse mode the core that can hold a larger clique
+    int GetReducedVertices();
+
+    size_t GetReducedEdges();
+
+    // no clique is larger than this, equal to the clique size when the search is complete
+    int GetUpperBound();
+
+    // the clique is proven optimal if the search finished or the bounds of everything left are no better
+    bool IsOptimal();
+
+    // "optimal" or "timeout-with-gap"
+    std::string GetStatus();
+
+    // seconds of the exact search summed over this run and the runs it resumed from
+    double GetTotalBnBTime();
+
+    // top-level subproblems left for a later run, 0 when the search is complete
+    int GetOpenSubproblems();
+
+    // top-level subproblems that were left in the checkpoint file the last run resumed from,
+    // -1 if it started from scratch
+    int GetResumedSubproblems();
+
+    // why the checkpoint file couldn't be read or written in the last run, empty if nothing went wrong
+    std::string GetCheckpointError();
+
+    // subproblems of the last sparse search that went to the dense search
+    int GetSparseSubproblems();
+
+    // heap allocations made by the last search, not counting the heuristic and the preparation before it
+    long long GetSearchAllocations();
+
+    // where the last exact search spent its time, incumbents are seconds since RunBnB started
+    const BnBProfile& GetProfile();
+
+    bool Check();
+
+    std::string PrintClique();
+
+private:
+    // PMC-style search on the CSR graph: a greedy clique over the degeneracy order is the heuristic,
+    // the subproblems of the vertices that can beat it are the exact search
+    std::tuple<double, double> RunSparse(std::chrono::steady_clock::time_point start, const BnBOptions& options);
+
+    // every subtree left at the deadline is also bounded by a coloring of the whole kernel,
+    // in smallest-last order it takes at most degeneracy + 1 colors
+    void LimitUpperBound(const std::vector<int>& kernel_order);
+
+    void FinishCheckpoint(BnBCheckpoint& checkpoint);
+
+    // buffers of one recursion depth, reserved for the whole graph before the search starts
+    struct DepthScratch
+    {
+        std::vector<int> candidates;
+        std::vector<int> branch_vertices;
+        std::vector<int> branch_colors;
+    };
+
+    // the clique can't be larger than degeneracy + 1, so that many depths and clique slots are enough
+    void PrepareSearch(int degeneracy);
+
+    //candidates of the depth should be stored in antipardalos order for coloring. Bound is the coloring bound
+    //of the node given by its parent, it is kept if the node is cut off at the deadline
+    void BnBRecursion(int depth, int bound);
+
+private:
+    GraphHandle graph;
+    bool sparse = false;
+    // the tabu search that finds the initial clique of the dense mode, made by its first run
+    std::unique_ptr<MaxCliqueTabuSearch> heuristic;
+    int reduced_vertices = 0;
+    size_t reduced_edges = 0;
+    // the part of the graph the exact search runs on, its neighbours are those of the whole graph if nothing was removed
+    CliqueKernel search_graph;
+    const std::vector<std::unordered_set<int>>* search_neighbours = nullptr;
+    std::unordered_set<int> best_clique;
+    // the clique of the hash-set recursion and the best one, both are stacks with fixed capacity
+    std::vector<int> clique;
+    std::vector<int> best_vertices;
+    std::vector<DepthScratch> depth_scratch;
+    ColoringScratch coloring_scratch;
+    std::vector<long long> visit_stamp;
+    long long nodes = 0;
+    long long maxsat_prunes = 0;
+    long long search_allocations = 0;
+    BnBProfile profile;
+    // started with RunBnB, the incumbents of the hash-set recursion are timed by it
+    ProfileClock run_clock;
+    // the deadline is checked once per this many nodes, must be a power of two
+    static const long long kDeadlineCheckNodes = 1024;
+    std::chrono::steady_clock::time_point deadline;
+    bool stopped = false;
+    int upper_bound = 0;
+    double total_bnb_time = 0;
+    int open_subproblems = 0;
+    int resumed_subproblems = -1;
+    std::string checkpoint_error;
+    int sparse_subproblems = 0;
+    ColoringMode coloring_mode = ColoringMode::Greedy;
+};
@@ -2,195 +2,45 @@
 #include <fstream>
 #include <string>
 #include <vector>
-#include <sstream>
-#include <time.h>
 #include <random>
-#include <unordered_set>
-#include <algorithm>
+#include <tuple>
+#include <atomic>
+#include <cstdlib>
+#include <new>
 
-#include "tabu_max_clique.h"
+#include "../Common/benchmark.h"
+#include "../Common/graph_handle.h"
+#include "bnb_solver.h"
 #include "utils.h"
 
 using namespace std;
 
-class BnBSolver
-{
-public:
-    void ReadGraphFile(string filename)
-    {
-        ifstream fin(filename);
-        string line;
-        int vert = 0, edges = 0;
-        while (getline(fin, line))
-        {
-            if (line[0] == 'c')
-            {
-                continue;
-            }
-            if (line[0] == 'p')
-            {
-                stringstream s(line);
-                char c;
-                string in;
-                s >> c >> in >> vert >> edges;
-                neighbours.resize(vert);
-            }
-            else
-            {
-                stringstream s(line);
-                char c;
-                int st, fn;
-                s >> c >> st >> fn;
-                neighbours[st - 1].insert(fn - 1);
-                neighbours[fn - 1].insert(st - 1);
-            }
-        }
-    }
-
-    tuple<double, double> RunBnB(long time_limit)
-    {
-        clock_t start = clock();
-        clock_t deadline = start + time_limit * 1000;
-        MaxCliqueTabuSearch st;
-        st.Init(neighbours);
-        st.RunSearch(1000);
-        best_clique = st.GetClique();
-        clock_t heuristic_finish = clock();
-        
-        clique.clear();
-        auto pardalos = PardalosOrder(neighbours);
-        for (int i = 0; i < pardalos.size(); ++i)
-        {
-            if (clock() > deadline)
-            {
-                break;
-            }
-            int vertex = pardalos[i];
-
-            vector<int> new_candidates;
-            new_candidates.reserve(pardalos.size());
-            for (int j = pardalos.size() - 1; j > i; --j)
-            {
-                if (neighbours[vertex].count(pardalos[j]))
-                {
-                    new_candidates.push_back(pardalos[j]);
-                }
-            }
-            clique.insert(vertex);
-            BnBRecursion(new_candidates);
-            clique.erase(vertex);
-        }
-        clock_t finish = clock();
-        return make_tuple(double(heuristic_finish - start) / 1000, double(finish - heuristic_finish) / 1000);
-    }
-
-    const unordered_set<int>& GetClique()
-    {
-        return best_clique;
-    }
-
-    bool Check()
-    {
-        for (int i : best_clique)
-        {
-            for (int j : best_clique)
-            {
-                if (i != j && neighbours[i].count(j) == 0)
-                {
-                    cout << "Returned subgraph is not clique\n";
-                    return false;
-                }
-            }
-        }
-        return true;
-    }
+// every heap allocation of the program is counted, so the benchmark can show how many happen inside the search
+static atomic<long long> allocations{ 0 };
 
-    string PrintClique()
+void* operator new(size_t size)
+{
+    ++allocations;
+    if (void* memory = malloc(size ? size : 1))
     {
-        vector<int> clique;
-        clique.insert(clique.end(), best_clique.begin(), best_clique.end());
-        sort(clique.begin(), clique.end());
-        stringstream ss;
-        ss << "\"";
-        bool first_vertex = true;
-        ss << "{";
-        for (const auto& vertex : clique)
-        {
-            if (!first_vertex)
-            {
-                ss << ",";
-            }
-            ss << vertex;
-            first_vertex = false;
-        }
-        ss << "}";
-        ss << "\"";
-        return ss.str();
+        return memory;
     }
+    throw bad_alloc();
+}
 
-private:
-    //candidates should be passed in antipardalos order for coloring
-    void BnBRecursion(const vector<int>& candidates)
-    {
-        if (candidates.empty())
-        {
-            if (clique.size() > best_clique.size())
-            {
-                best_clique = clique;
-            }
-            return;
-        }
-
-        auto [maxcolor, colors] = GreedyGraphColoring(neighbours, candidates);
-
-        vector<vector<int>> colors_to_vertices(maxcolor + 1);
-        //traverse in pardalos order
-        for (int i = candidates.size() - 1; i >= 0; --i)
-        {
-            auto vertex = candidates[i];
-            colors_to_vertices[colors[vertex]].push_back(vertex);
-        }
-
-        vector<bool> visited_candidates(neighbours.size(), false);
-        for (int color = maxcolor; color > 0; --color)
-        {
-            if (clique.size() + color <= best_clique.size()) 
-            {
-                return;
-            }
-            
-            for (int vertex_to_add : colors_to_vertices[color])
-            {
-                visited_candidates[vertex_to_add] = true;
-                    
-                vector<int> new_candidates;
-                new_candidates.reserve(candidates.size());
-                for (int candidate : candidates)
-                {
-                    if (!visited_candidates[candidate] && neighbours[vertex_to_add].count(candidate))
-                    {
-                        new_candidates.push_back(candidate);
-                    }
-                }
-                clique.insert(vertex_to_add);
-                BnBRecursion(new_candidates);
-                clique.erase(vertex_to_add);
-            }
-        }
-    }
+void operator delete(void* memory) noexcept
+{
+    free(memory);
+}
 
-private:
-    vector<unordered_set<int>> neighbours;
-    unordered_set<int> best_clique;
-    unordered_set<int> clique;
-};
+void operator delete(void* memory, size_t) noexcept
+{
+    free(memory);
+}
 
-int main()
+int main(int argc, char* argv[])
 {
-    cout << "Time limit (sec): ";
-    long time_limit;
-    cin >> time_limit;
-    vector<string> files = {
+    vector<string> default_files = {
     "brock200_1.clq", "brock200_2.clq", "brock200_3.clq", "brock200_4.clq", /*"brock400_1.clq", "brock400_2.clq", "brock400_3.clq", "brock400_4.clq",*/
     "C125.9.clq",
     "gen200_p0.9_44.clq", "gen200_p0.9_55.clq",
@@ -200,21 +50,95 @@ int main()
     "MANN_a27.clq", "MANN_a9.clq",
     "p_hat1000-1.clq", /*"p_hat1000-2.clq",*/ "p_hat1500-1.clq", "p_hat300-3.clq", /*"p_hat500-3.clq",*/
     "san1000.clq", "sanr200_0.9.clq"/*, "sanr400_0.7.clq"*/};
+    // --time-limit sec, --engine hash|bitset, --threads N, --coloring greedy|renumber, --bound coloring|maxsat,
+    // --checkpoint-dir dir to keep <dir>/<instance>.checkpoint files, --checkpoint-interval sec,
+    // --mode dense|sparse, sparse runs the PMC-style search on the CSR graph without the tabu search and the checkpoint,
+    // --bitset-width fixed|dynamic, dynamic keeps the bitset engine off the kernels compiled for a word count,
+    // --profile name writes the search profile of every run to name.json, name.csv and name_anytime.csv,
+    // the rest of the options are described in benchmark.h
+    BenchmarkOptions benchmark = ParseBenchmarkOptions(argc, argv, default_files, mt19937::default_seed);
+    double time_limit = benchmark.GetDouble("time-limit", 3600);
+    BnBSolver::CountAllocationsWith(&allocations);
+    BnBOptions options;
+    options.engine = benchmark.GetString("engine", "bitset") == "hash" ? BnBEngine::HashSets : BnBEngine::Bitset;
+    options.threads = benchmark.GetInt("threads", 1);
+    options.coloring = benchmark.GetString("coloring", "greedy") == "renumber" ? ColoringMode::Renumber : ColoringMode::Greedy;
+    options.bound = benchmark.GetString("bound", "coloring") == "maxsat" ? PruningBound::MaxSat : PruningBound::Coloring;
+    options.fixed_width = benchmark.GetString("bitset-width", "fixed") != "dynamic";
+    bool sparse = benchmark.GetString("mode", "dense") == "sparse";
+    string checkpoint_dir = sparse ? "" : benchmark.GetString("checkpoint-dir", "");
+    options.checkpoint_interval = benchmark.GetDouble("checkpoint-interval", options.checkpoint_interval);
+    BenchmarkReport report("clique_bnb", "Clique size", QualityGoal::Maximize, "BnB time (sec)", benchmark);
+    ProfileReport profile_report(benchmark.GetString("profile", ""));
 
     ofstream fout("clique_bnb.csv");
-    fout << "File,Heuristic time (sec),BnB time (sec),Clique size,Clique vertices," << time_limit << "\n";
-    for (string file : files)
+    fout << "File,Load time (sec),Heuristic time (sec),Reduced vertices,Reduced edges,BnB time (sec),Total BnB time (sec),Open subproblems,Nodes,MaxSAT prunes,Search allocations,Status,Upper bound,Clique size,Clique vertices," << time_limit << "\n";
+    for (string file : benchmark.files)
     {
-        BnBSolver problem;
-        problem.ReadGraphFile(file);
-        auto [heuristic_time, bnb_time] = problem.RunBnB(time_limit);
-        if (! problem.Check())
+        // in the sparse mode files other than .clq are read as edge lists. The load time covers reading the file
+        // and the neighbour sets of the dense mode
+        BenchmarkTimer load_timer;
+        bool dimacs = file.size() >= 4 && file.compare(file.size() - 4, 4, ".clq") == 0;
+        GraphHandle graph = !sparse || dimacs ? GraphHandle::LoadDimacs(file) : GraphHandle::LoadEdgeList(file);
+        BnBSolver problem(graph, sparse);
+        double load_time = load_timer.WallSeconds();
+        if (graph.size() == 0)
+        {
+            cout << "Can't read graph file " << file << "\n";
+        }
+        if (!checkpoint_dir.empty())
+        {
+            options.checkpoint_file = checkpoint_dir + "/" + file + ".checkpoint";
+        }
+        // the row of an instance shows the last run, its BnB time is replaced by the median of all the runs
+        double heuristic_time = 0;
+        for (unsigned seed : benchmark.seeds)
         {
-            cout << "*** WARNING: incorrect clique ***\n";
-            fout << "*** WARNING: incorrect clique ***\n";
+            for (int rep = 0; rep < benchmark.repetitions; ++rep)
+            {
+                options.seed = seed;
+                BenchmarkTimer timer;
+                double bnb_time;
+                tie(heuristic_time, bnb_time) = problem.RunBnB(time_limit, options);
+                double cpu_time = timer.CpuSeconds();
+                if (problem.GetResumedSubproblems() >= 0)
+                {
+                    cout << "Resumed from " << options.checkpoint_file << ", " << problem.GetResumedSubproblems() << " top-level subproblems were left\n";
+                }
+                if (!problem.GetCheckpointError().empty())
+                {
+                    cout << problem.GetCheckpointError() << "\n";
+                }
+                if (sparse)
+                {
+                    cout << "Sparse search: " << graph.size() << " vertices, " << graph.EdgeCount() << " edges, "
+                        << problem.GetSparseSubproblems() << " subproblems searched, " << problem.GetReducedVertices()
+                        << " vertices left in the " << problem.GetClique().size() << "-core\n";
+                }
+                else
+                {
+                    cout << "Reduced graph: " << graph.size() << " -> " << problem.GetReducedVertices() << " vertices, "
+                        << graph.EdgeCount() << " -> " << problem.GetReducedEdges() << " edges\n";
+                }
+                bool valid = problem.Check();
+                if (!valid)
+                {
+                    cout << "*** WARNING: incorrect clique ***\n";
+                    fout << "*** WARNING: incorrect clique ***\n";
+                }
+                // the baseline column is the BnB time, so the heuristic is left out of the wall time,
+                // the CPU time covers both
+                report.AddRun(file, seed, bnb_time, cpu_time, problem.GetClique().size(), valid);
+                profile_report.AddRun(file, seed, problem.GetProfile());
+            }
         }
-        fout << file << "," << heuristic_time << "," << bnb_time << "," << problem.GetClique().size() << "," << problem.PrintClique() << ",\n";
-        cout << file << "," << heuristic_time << "," << bnb_time << "," << problem.GetClique().size() << "," << problem.PrintClique() << ",\n";
+        double bnb_time = report.WallStatistics(file).median;
+        fout << file << "," << load_time << "," << heuristic_time << "," << problem.GetReducedVertices() << "," << problem.GetReducedEdges() << "," << bnb_time << "," << problem.GetTotalBnBTime() << "," << problem.GetOpenSubproblems() << "," << problem.GetNodes() << "," << problem.GetMaxSatPrunes() << "," << problem.GetSearchAllocations() << "," << problem.GetStatus() << "," << problem.GetUpperBound() << "," << problem.GetClique().size() << "," << problem.PrintClique() << ",\n";
+        cout << file << "," << load_time << "," << heuristic_time << "," << problem.GetReducedVertices() << "," << problem.GetReducedEdges() << "," << bnb_time << "," << problem.GetTotalBnBTime() << "," << problem.GetOpenSubproblems() << "," << problem.GetNodes() << "," << problem.GetMaxSatPrunes() << "," << problem.GetSearchAllocations() << "," << problem.GetStatus() << "," << problem.GetUpperBound() << "," << problem.GetClique().size() << "," << problem.PrintClique() << ",\n";
     }
+    fout.close();
+    report.CompareWithBaseline();
+    report.WriteJson();
+    profile_report.Write();
     return 0;
 }
@@ -0,0 +1,429 @@
+#include <algorithm>
+
+#include "sparse_clique.h"
+#include "bitset_clique.h"
+#include "bnb_checkpoint.h"
+#include "../Common/work_stealing_pool.h"
+
+using namespace std;
+
+SparseCliqueSearch::SparseCliqueSearch(const CsrGraph& graph) : graph(graph)
+{
+}
+
+void SparseCliqueSearch::FindInitialClique()
+{
+    int vertices = graph.size();
+    degeneracy = ComputeDegeneracyOrder(graph);
+    position.resize(vertices);
+    for (int i = 0; i < vertices; ++i)
+    {
+        position[degeneracy.order[i]] = i;
+    }
+    clique.clear();
+
+    const vector<int>& core_numbers = degeneracy.core_numbers;
+    SubproblemState state;
+    vector<int>& candidates = state.candidates;
+    vector<int> current;
+    for (int i = vertices - 1; i >= 0; --i)
+    {
+        int vertex = degeneracy.order[i];
+        // core numbers don't grow towards the start of the order, so no vertex left can beat the clique
+        if (core_numbers[vertex] + 1 <= (int)clique.size())
+        {
+            break;
+        }
+        CollectCandidates(state, vertex, clique.size());
+        if (candidates.size() < clique.size())
+        {
+            continue;
+        }
+        sort(candidates.begin(), candidates.end(), [&](int a, int b)
+            {
+                return core_numbers[a] != core_numbers[b] ? core_numbers[a] > core_numbers[b] : position[a] > position[b];
+            });
+        current.assign(1, vertex);
+        for (int k = 0; k < candidates.size() && current.size() + candidates.size() - k > clique.size(); ++k)
+        {
+            int candidate = candidates[k];
+            bool fits = true;
+            for (int j = 1; j < current.size() && fits; ++j)
+            {
+                fits = IsAdjacent(candidate, current[j]);
+            }
+            if (fits)
+            {
+                current.push_back(candidate);
+            }
+        }
+        if (current.size() > clique.size())
+        {
+            clique = current;
+        }
+    }
+}
+
+void SparseCliqueSearch::Run(chrono::steady_clock::time_point search_deadline, const BnBOptions& options)
+{
+    nodes = 0;
+    maxsat_prunes = 0;
+    subproblems = 0;
+    open_subproblems = 0;
+    stopped = false;
+    upper_bound = 0;
+    best_size = clique.size();
+    deadline = search_deadline;
+    profile = BnBProfile();
+    run_clock.Start();
+    // the threads go to the subproblems, a pool inside every one of them would cost more than most of them take,
+    // and the progress is not kept on disk
+    subproblem_options = options;
+    subproblem_options.threads = 1;
+    subproblem_options.checkpoint_file.clear();
+    BuildSchedule();
+
+    int threads = max(1, options.threads);
+    states.assign(threads, SubproblemState());
+    if (threads == 1)
+    {
+        SolveBlock(states[0], 0, schedule.size());
+    }
+    else
+    {
+        WorkStealingPool workers(threads);
+        // the shared queue is first in first out, so the blocks start in the order of the schedule
+        for (int begin = 0; begin < schedule.size(); begin += kScheduleBlock)
+        {
+            int end = min<int>(begin + kScheduleBlock, schedule.size());
+            workers.Submit([this, &workers, begin, end]
+                {
+                    SolveBlock(states[workers.CurrentWorker()], begin, end);
+                });
+        }
+        workers.Wait();
+    }
+    for (const auto& state : states)
+    {
+        nodes += state.nodes;
+        maxsat_prunes += state.maxsat_prunes;
+        subproblems += state.subproblems;
+        profile.Merge(state.profile);
+    }
+    states.clear();
+    schedule.clear();
+    RecordBound(clique.size());
+    profile.search_seconds = run_clock.Seconds();
+}
+
+const vector<int>& SparseCliqueSearch::GetClique()
+{
+    return clique;
+}
+
+long long SparseCliqueSearch::GetNodes()
+{
+    return nodes;
+}
+
+long long SparseCliqueSearch::GetMaxSatPrunes()
+{
+    return maxsat_prunes;
+}
+
+int SparseCliqueSearch::GetSubproblems()
+{
+    return subproblems;
+}
+
+int SparseCliqueSearch::GetOpenSubproblems()
+{
+    return open_subproblems;
+}
+
+int SparseCliqueSearch::GetCoreVertices()
+{
+    int count = 0;
+    for (int core : degeneracy.core_numbers)
+    {
+        count += core >= (int)clique.size();
+    }
+    return count;
+}
+
+size_t SparseCliqueSearch::GetCoreEdges()
+{
+    const vector<int>& core_numbers = degeneracy.core_numbers;
+    int k = clique.size();
+    size_t edges = 0;
+    for (int v = 0; v < graph.size(); ++v)
+    {
+        if (core_numbers[v] < k)
+        {
+            continue;
+        }
+        for (int u : graph[v])
+        {
+            edges += u > v && core_numbers[u] >= k;
+        }
+    }
+    return edges;
+}
+
+bool SparseCliqueSearch::IsStopped()
+{
+    return stopped;
+}
+
+int SparseCliqueSearch::GetUpperBound()
+{
+    return upper_bound;
+}
+
+const BnBProfile& SparseCliqueSearch::GetProfile()
+{
+    return profile;
+}
+
+bool SparseCliqueSearch::IsAdjacent(int a, int b) const
+{
+    if (graph[a].size() > graph[b].size())
+    {
+        swap(a, b);
+    }
+    NeighbourRange row = graph[a];
+    return binary_search(row.begin(), row.end(), b);
+}
+
+void SparseCliqueSearch::CollectCandidates(SubproblemState& state, int vertex, int min_core)
+{
+    state.candidates.clear();
+    for (int neighbour : graph[vertex])
+    {
+        if (position[neighbour] > position[vertex] && degeneracy.core_numbers[neighbour] >= min_core)
+        {
+            state.candidates.push_back(neighbour);
+        }
+    }
+}
+
+bool SparseCliqueSearch::BuildSubgraph(SubproblemState& state, int clique_size)
+{
+    const vector<int>& candidates = state.candidates;
+    int count = candidates.size();
+    if (count < clique_size - 1)
+    {
+        return false;
+    }
+
+    // rows of the candidates among themselves, both are sorted, so a row is merged with the candidates
+    // or, if it belongs to a hub, probed for every one of them
+    state.local_offsets.assign(count + 1, 0);
+    state.local_adjacency.clear();
+    for (int i = 0; i < count; ++i)
+    {
+        NeighbourRange row = graph[candidates[i]];
+        if (row.size() > (size_t)count * kBinarySearchRatio)
+        {
+            for (int j = 0; j < count; ++j)
+            {
+                if (binary_search(row.begin(), row.end(), candidates[j]))
+                {
+                    state.local_adjacency.push_back(j);
+                }
+            }
+        }
+        else
+        {
+            const int* neighbour = row.begin();
+            for (int j = 0; j < count && neighbour != row.end(); ++j)
+            {
+                while (neighbour != row.end() && *neighbour < candidates[j])
+                {
+                    ++neighbour;
+                }
+                if (neighbour != row.end() && *neighbour == candidates[j])
+                {
+                    state.local_adjacency.push_back(j);
+                }
+            }
+        }
+        state.local_offsets[i + 1] = state.local_adjacency.size();
+    }
+
+    // a candidate with fewer than clique_size - 2 neighbours among the others left can't be in the clique,
+    // removed ones get degree -1
+    int needed = clique_size - 2;
+    state.local_degree.resize(count);
+    state.peeled.clear();
+    for (int i = 0; i < count; ++i)
+    {
+        state.local_degree[i] = state.local_offsets[i + 1] - state.local_offsets[i];
+        if (state.local_degree[i] < needed)
+        {
+            state.local_degree[i] = -1;
+            state.peeled.push_back(i);
+        }
+    }
+    for (size_t p = 0; p < state.peeled.size(); ++p)
+    {
+        int i = state.peeled[p];
+        for (size_t e = state.local_offsets[i]; e < state.local_offsets[i + 1]; ++e)
+        {
+            int j = state.local_adjacency[e];
+            if (state.local_degree[j] >= 0 && --state.local_degree[j] < needed)
+            {
+                state.local_degree[j] = -1;
+                state.peeled.push_back(j);
+            }
+        }
+    }
+    if (count - (int)state.peeled.size() < clique_size - 1)
+    {
+        return false;
+    }
+
+    state.kept.clear();
+    state.renumbered.assign(count, -1);
+    for (int i = 0; i < count; ++i)
+    {
+        if (state.local_degree[i] >= 0)
+        {
+            state.renumbered[i] = state.kept.size();
+            state.kept.push_back(state.candidates[i]);
+        }
+    }
+    state.subgraph.offsets.assign(state.kept.size() + 1, 0);
+    state.subgraph.adjacency.clear();
+    for (int i = 0; i < count; ++i)
+    {
+        if (state.renumbered[i] < 0)
+        {
+            continue;
+        }
+        for (size_t e = state.local_offsets[i]; e < state.local_offsets[i + 1]; ++e)
+        {
+            int j = state.renumbered[state.local_adjacency[e]];
+            if (j >= 0)
+            {
+                state.subgraph.adjacency.push_back(j);
+            }
+        }
+        state.subgraph.offsets[state.renumbered[i] + 1] = state.subgraph.adjacency.size();
+    }
+    return true;
+}
+
+void SparseCliqueSearch::BuildSchedule()
+{
+    // core numbers don't grow towards the start of the degeneracy order, so its end has the largest ones.
+    // Ties stay in the order too, the vertices removed last sit in the densest part of the graph
+    const vector<int>& core_numbers = degeneracy.core_numbers;
+    int best = clique.size();
+    schedule.clear();
+    for (int i = graph.size() - 1; i >= 0 && core_numbers[degeneracy.order[i]] + 1 > best; --i)
+    {
+        schedule.push_back(degeneracy.order[i]);
+    }
+}
+
+void SparseCliqueSearch::SolveBlock(SubproblemState& state, int begin, int end)
+{
+    const vector<int>& core_numbers = degeneracy.core_numbers;
+    ProfileClock block_clock;
+    block_clock.Start();
+    int k = begin;
+    for (; k < end; ++k)
+    {
+        int vertex = schedule[k];
+        // the schedule goes by descending core number, so nothing left in the block can beat the best clique
+        if (core_numbers[vertex] + 1 <= best_size.load(memory_order_relaxed))
+        {
+            state.profile.AddThreadTime(block_clock.Seconds());
+            return;
+        }
+        if (stopped || chrono::steady_clock::now() > deadline)
+        {
+            stopped = true;
+            break;
+        }
+        if (!SolveSubproblem(state, vertex))
+        {
+            ++open_subproblems;
+            ++k;
+            break;
+        }
+    }
+    // the subproblems left at the deadline are bounded by their core numbers
+    for (; k < end; ++k)
+    {
+        int bound = core_numbers[schedule[k]] + 1;
+        if (bound > best_size.load(memory_order_relaxed))
+        {
+            ++open_subproblems;
+            RecordBound(bound);
+        }
+    }
+    state.profile.AddThreadTime(block_clock.Seconds());
+}
+
+bool SparseCliqueSearch::SolveSubproblem(SubproblemState& state, int vertex)
+{
+    // a vertex of a clique larger than the best one has best neighbours in it, so its core number is at least best
+    int best = best_size.load(memory_order_relaxed);
+    CollectCandidates(state, vertex, best);
+    if (!BuildSubgraph(state, best + 1))
+    {
+        return true;
+    }
+
+    ++state.subproblems;
+    DegeneracyOrder subproblem_order = ComputeDegeneracyOrder(state.subgraph);
+    BitsetCliqueSearch search;
+    // the bitset engine expands the last bit first
+    search.Init(state.subgraph, vector<int>(subproblem_order.order.rbegin(), subproblem_order.order.rend()));
+    search.SetLowerBound(best - 1);
+    BnBCheckpoint checkpoint("", 0);
+    checkpoint.Start(state.subgraph, subproblem_order.order);
+    search.Run({}, deadline, subproblem_options, checkpoint);
+    state.nodes += search.GetNodes();
+    state.maxsat_prunes += search.GetMaxSatPrunes();
+    // the block is timed as a whole, so building the subgraph counts as branching
+    BnBProfile subproblem_profile = search.GetProfile();
+    subproblem_profile.thread_seconds = 0;
+    state.profile.Merge(subproblem_profile);
+    auto subproblem_clique = search.GetClique();
+    if ((int)subproblem_clique.size() >= best)
+    {
+        UpdateBest(vertex, state, vector<int>(subproblem_clique.begin(), subproblem_clique.end()));
+    }
+    if (search.IsStopped())
+    {
+        RecordBound(1 + search.GetUpperBound());
+        return false;
+    }
+    return true;
+}
+
+void SparseCliqueSearch::UpdateBest(int vertex, const SubproblemState& state, const vector<int>& subproblem_clique)
+{
+    lock_guard<mutex> lock(best_mutex);
+    if (subproblem_clique.size() + 1 > clique.size())
+    {
+        clique.assign(1, vertex);
+        for (int v : subproblem_clique)
+        {
+            clique.push_back(state.kept[v]);
+        }
+        best_size = clique.size();
+        profile.RecordIncumbent(run_clock.Seconds(), clique.size());
+    }
+}
+
+void SparseCliqueSearch::RecordBound(int bound)
+{
+    int current = upper_bound.load(memory_order_relaxed);
+    while (bound > current && !upper_bound.compare_exchange_weak(current, bound))
+    {
+    }
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+#include "utils.h"
+#include "../Common/dimacs_loader.h"
+#include "../Common/degeneracy_order.h"
+#include "../Common/search_profile.h"
+
+// PMC-style exact search for large sparse graphs. The graph stays in CSR form and the rest of the memory is linear
+// in its size. The subproblem of a vertex is its neighbours later in the degeneracy order, so it has at most
+// core number vertices. Neighbours whose core number can't be in a larger clique are left out, the rest is peeled
+// by degree and searched as a small dense graph by BitsetCliqueSearch
+class SparseCliqueSearch
+{
+public:
+    // the graph is kept by reference and has to outlive the search
+    explicit SparseCliqueSearch(const CsrGraph& graph);
+
+    // computes the degeneracy order and the core numbers, then grows a greedy clique in the subproblem of every
+    // vertex that can still beat the best one, taking the candidates with larger core numbers first
+    void FindInitialClique();
+
+    // solves the subproblems that can beat the initial clique until the deadline. They are scheduled by descending
+    // core number, so the ones most likely to raise the clique come first. With several threads blocks of the
+    // schedule are tasks of a work-stealing pool, a subproblem is skipped as soon as its core number can't beat
+    // the shared best clique, and each one is searched on a single thread
+    void Run(std::chrono::steady_clock::time_point deadline, const BnBOptions& options);
+
+    const std::vector<int>& GetClique();
+
+    long long GetNodes();
+
+    long long GetMaxSatPrunes();
+
+    // subproblems that were left after the core and degree pruning and went to the dense search
+    int GetSubproblems();
+
+    // subproblems left at the deadline that could still beat the best clique, 0 when the search is complete
+    int GetOpenSubproblems();
+
+    // vertices and edges of the k-core that can hold a clique larger than the best one, i.e. k = best clique size
+    int GetCoreVertices();
+
+    size_t GetCoreEdges();
+
+    // true if the search stopped at the deadline before it was complete
+    bool IsStopped();
+
+    // no clique is larger than this, equal to the clique size when the search is complete
+    int GetUpperBound();
+
+    // counters of the subproblem searches, their depth 0 is the first vertex after the subproblem one.
+    // The incumbents are seconds since Run started
+    const BnBProfile& GetProfile();
+
+private:
+    // buffers of the subproblem a thread works on and its counters, every thread has its own
+    struct SubproblemState
+    {
+        // later neighbours of the vertex that are left, in ascending vertex order. The local number of a vertex
+        // is its index here
+        std::vector<int> candidates;
+        std::vector<int> local_degree;
+        std::vector<int> peeled;
+        std::vector<int> renumbered;
+        // vertices of the subgraph in its local numbering
+        std::vector<int> kept;
+        std::vector<size_t> local_offsets;
+        std::vector<int> local_adjacency;
+        CsrGraph subgraph;
+        long long nodes = 0;
+        long long maxsat_prunes = 0;
+        int subproblems = 0;
+        BnBProfile profile;
+    };
+
+    // a row is probed with binary_search instead of merged with the candidates when it is this many times longer
+    static const int kBinarySearchRatio = 16;
+
+    // subproblems of the schedule in one task of the pool
+    static const int kScheduleBlock = 16;
+
+    const CsrGraph& graph;
+    DegeneracyOrder degeneracy;
+    std::vector<int> position;
+    // vertices whose subproblems can beat the initial clique, in the order they are solved
+    std::vector<int> schedule;
+    BnBOptions subproblem_options;
+    std::chrono::steady_clock::time_point deadline;
+    std::vector<SubproblemState> states;
+
+    std::vector<int> clique;
+    std::atomic<int> best_size{0};
+    std::mutex best_mutex;
+    long long nodes = 0;
+    long long maxsat_prunes = 0;
+    int subproblems = 0;
+    std::atomic<int> open_subproblems{0};
+    std::atomic<bool> stopped{false};
+    std::atomic<int> upper_bound{0};
+    // incumbents are recorded under best_mutex
+    BnBProfile profile;
+    ProfileClock run_clock;
+
+    bool IsAdjacent(int a, int b) const;
+
+    // later neighbours of the vertex whose core numbers are at least min_core
+    void CollectCandidates(SubproblemState& state, int vertex, int min_core);
+
+    // a function to build the subgraph of the candidates that can be in a clique of clique_size vertices together
+    // with the subproblem vertex: every one of them needs clique_size - 2 neighbours among the others.
+    // Returns false if fewer than clique_size - 1 are left, the subgraph is in local numbering of the ones kept
+    bool BuildSubgraph(SubproblemState& state, int clique_size);
+
+    // the vertices with a core number that can beat the best clique in the order Run solves them
+    void BuildSchedule();
+
+    // solves the subproblems of the schedule from begin to end, the ones left at the deadline are counted as open
+    void SolveBlock(SubproblemState& state, int begin, int end);
+
+    // returns false if the search of the subproblem stopped at the deadline
+    bool SolveSubproblem(SubproblemState& state, int vertex);
+
+    void UpdateBest(int vertex, const SubproblemState& state, const std::vector<int>& subproblem_clique);
+
+    void RecordBound(int bound);
+};
@@ -1,73 +1,269 @@
-#include <unordered_map>
+#include <algorithm>
 
+#include "../Common/bit_ops.h"
 #include "utils.h"
 using namespace std;
 
-tuple<int, vector<int>> GreedyGraphColoring(const vector<unordered_set<int>>& neighbour_sets, const vector<int>& vertices_order)
+void ColoringScratch::Init(int vertices)
 {
+    colors.assign(vertices, 0);
+    conflicts.assign(vertices + 2, 0);
+    conflict_vertex.assign(vertices + 2, -1);
+    moved_conflicts.assign(vertices + 1, 0);
+    class_start.assign(vertices + 2, 0);
+}
+
+void ColorForBranching(const vector<unordered_set<int>>& neighbour_sets, const vector<int>& vertices_order, int k_min, bool renumber,
+    ColoringScratch& scratch, vector<int>& branch_vertices, vector<int>& branch_colors)
+{
+    if (k_min < 0)
+    {
+        k_min = 0;
+    }
+    vector<int>& colors = scratch.colors;
+    vector<int>& conflicts = scratch.conflicts;
+    vector<int>& conflict_vertex = scratch.conflict_vertex;
     int maxcolor = 0;
-    vector<int> colors(neighbour_sets.size(), 0);
     for (int vertex : vertices_order)
     {
-        vector<bool> colors_used(maxcolor + 1, false);
-
+        // number of neighbours of the vertex in every class and one of them, class 0 collects the uncolored ones
+        fill(conflicts.begin(), conflicts.begin() + maxcolor + 2, 0);
         for (int neighbour : neighbour_sets[vertex])
         {
-            colors_used[colors[neighbour]] = true;
+            ++conflicts[colors[neighbour]];
+            conflict_vertex[colors[neighbour]] = neighbour;
         }
 
         int color = 1;
-        for (color; color < colors_used.size(); ++color)
+        while (color <= maxcolor && conflicts[color] > 0)
         {
-            if (!colors_used[color])
+            ++color;
+        }
+
+        // Re-NUMBER: the vertex would be branched on, so try to squeeze it into one of the first k_min classes
+        for (int k1 = 1; renumber && color > k_min && k1 <= k_min; ++k1)
+        {
+            if (conflicts[k1] != 1)
+            {
+                continue;
+            }
+            int moved = conflict_vertex[k1];
+            fill(scratch.moved_conflicts.begin(), scratch.moved_conflicts.begin() + k_min + 1, 0);
+            for (int neighbour : neighbour_sets[moved])
             {
-                colors[vertex] = color;
-                break;
+                if (colors[neighbour] <= k_min)
+                {
+                    ++scratch.moved_conflicts[colors[neighbour]];
+                }
             }
+            for (int k2 = 1; k2 <= k_min; ++k2)
+            {
+                if (k2 != k1 && scratch.moved_conflicts[k2] == 0)
+                {
+                    colors[moved] = k2;
+                    color = k1;
+                    break;
+                }
+            }
+        }
+
+        colors[vertex] = color;
+        maxcolor = max(maxcolor, color);
+    }
+
+    // vertices of every class above k_min keep the order they were colored in
+    vector<int>& class_start = scratch.class_start;
+    fill(class_start.begin(), class_start.begin() + maxcolor + 2, 0);
+    for (int vertex : vertices_order)
+    {
+        if (colors[vertex] > k_min)
+        {
+            ++class_start[colors[vertex] + 1];
         }
-        if (color == maxcolor + 1)
+    }
+    for (int color = 1; color <= maxcolor; ++color)
+    {
+        class_start[color + 1] += class_start[color];
+    }
+    branch_vertices.resize(class_start[maxcolor + 1]);
+    branch_colors.resize(class_start[maxcolor + 1]);
+    for (int vertex : vertices_order)
+    {
+        int color = colors[vertex];
+        if (color > k_min)
         {
-            colors[vertex] = ++maxcolor;
+            branch_vertices[class_start[color]] = vertex;
+            branch_colors[class_start[color]] = color;
+            ++class_start[color];
         }
+        // the next call expects every vertex to be uncolored
+        colors[vertex] = 0;
     }
-    return make_tuple(maxcolor, colors);
 }
 
-vector<int> PardalosOrder(const vector<unordered_set<int>>& neighbour_sets)
+CliqueKernel ReduceForClique(const vector<unordered_set<int>>& neighbour_sets, int clique_size)
 {
-    unordered_map<int, unordered_set<int>> graph_cut;
-    for (int i = 0; i < neighbour_sets.size(); ++i)
+    // the adjacency rows take supported_vertices^2 / 8 bytes
+    const int kMaxSupportedVertices = 1 << 14;
+    int vertices = neighbour_sets.size();
+    int min_degree = clique_size;
+    int min_support = clique_size - 1;
+
+    vector<int> degree(vertices);
+    vector<bool> removed(vertices, false);
+    vector<int> queue;
+    for (int v = 0; v < vertices; ++v)
     {
-        graph_cut[i] = neighbour_sets[i];
+        degree[v] = neighbour_sets[v].size();
+        if (degree[v] < min_degree)
+        {
+            removed[v] = true;
+            queue.push_back(v);
+        }
     }
 
-    vector<int> vertices;
-    // everytime we remove a vertex we need to change our graph, i.e. to remove edges leading to that vertex
-    while (!graph_cut.empty())
+    // rows of the vertices left after the first peeling, bit index[u] is set while the edge is there
+    vector<int> index(vertices, -1);
+    int words = 0;
+    vector<Word> rows;
+    auto has_edge = [&](int v, int u)
+    {
+        return rows.empty() || (rows[(size_t)index[v] * words + index[u] / kWordBits] >> (index[u] % kWordBits) & 1);
+    };
+    auto remove_edge = [&](int v, int u)
+    {
+        rows[(size_t)index[v] * words + index[u] / kWordBits] &= ~(Word(1) << (index[u] % kWordBits));
+        rows[(size_t)index[u] * words + index[v] / kWordBits] &= ~(Word(1) << (index[v] % kWordBits));
+    };
+    auto peel = [&]()
     {
-        int min_degree_vertex = graph_cut.begin()->first;
-        for (const auto& [vertex, neighbours] : graph_cut)
+        while (!queue.empty())
         {
-            if (neighbours.size() < graph_cut[min_degree_vertex].size())
+            int vertex = queue.back();
+            queue.pop_back();
+            for (int neighbour : neighbour_sets[vertex])
             {
-                min_degree_vertex = vertex;
+                if ((removed[neighbour] && index[neighbour] < 0) || !has_edge(vertex, neighbour))
+                {
+                    continue;
+                }
+                if (!rows.empty())
+                {
+                    remove_edge(vertex, neighbour);
+                }
+                if (!removed[neighbour] && --degree[neighbour] < min_degree)
+                {
+                    removed[neighbour] = true;
+                    queue.push_back(neighbour);
+                }
             }
         }
-        vertices.push_back(min_degree_vertex);
-        for (int neighbour : graph_cut[min_degree_vertex])
+    };
+    peel();
+
+    bool edges_removed = false;
+    int left = 0;
+    for (int v = 0; v < vertices; ++v)
+    {
+        if (!removed[v])
         {
-            graph_cut[neighbour].erase(min_degree_vertex);
+            index[v] = left++;
         }
-        graph_cut.erase(min_degree_vertex);
     }
+    if (min_support > 0 && left <= kMaxSupportedVertices)
+    {
+        words = WordsFor(left);
+        rows.assign((size_t)left * words, 0);
+        for (int v = 0; v < vertices; ++v)
+        {
+            if (removed[v])
+            {
+                continue;
+            }
+            Word* row = &rows[(size_t)index[v] * words];
+            for (int neighbour : neighbour_sets[v])
+            {
+                if (!removed[neighbour])
+                {
+                    row[index[neighbour] / kWordBits] |= Word(1) << (index[neighbour] % kWordBits);
+                }
+            }
+        }
 
-    return vertices;
-}
+        // a removed edge can only lower the supports of the others, so the passes go on until one removes nothing
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            for (int v = 0; v < vertices; ++v)
+            {
+                for (int u : neighbour_sets[v])
+                {
+                    if (removed[v])
+                    {
+                        break;
+                    }
+                    if (u < v || removed[u] || !has_edge(v, u))
+                    {
+                        continue;
+                    }
+                    const Word* row_v = &rows[(size_t)index[v] * words];
+                    const Word* row_u = &rows[(size_t)index[u] * words];
+                    int support = 0;
+                    for (int w = 0; w < words && support < min_support; ++w)
+                    {
+                        support += PopCount(row_v[w] & row_u[w]);
+                    }
+                    if (support >= min_support)
+                    {
+                        continue;
+                    }
+                    remove_edge(v, u);
+                    changed = true;
+                    edges_removed = true;
+                    for (int end : { v, u })
+                    {
+                        if (--degree[end] < min_degree)
+                        {
+                            removed[end] = true;
+                            queue.push_back(end);
+                        }
+                    }
+                }
+            }
+            peel();
+        }
+    }
 
-vector<int> SmallDegreeLastWithRemoveOrder(const vector<unordered_set<int>>& neighbour_sets)
-{
-    auto vertices = PardalosOrder(neighbour_sets);
-    reverse(vertices.begin(), vertices.end());
-    return vertices;
+    CliqueKernel kernel;
+    for (int v = 0; v < vertices; ++v)
+    {
+        if (!removed[v])
+        {
+            kernel.vertices.push_back(v);
+        }
+    }
+    if (kernel.vertices.size() == vertices && !edges_removed)
+    {
+        for (const auto& vertex_neighbours : neighbour_sets)
+        {
+            kernel.edges += vertex_neighbours.size();
+        }
+        kernel.edges /= 2;
+        return kernel;
+    }
+    kernel.neighbour_sets.resize(vertices);
+    for (int v : kernel.vertices)
+    {
+        for (int neighbour : neighbour_sets[v])
+        {
+            if (!removed[neighbour] && has_edge(v, neighbour))
+            {
+                kernel.neighbour_sets[v].insert(neighbour);
+            }
+        }
+        kernel.edges += kernel.neighbour_sets[v].size();
+    }
+    kernel.edges /= 2;
+    return kernel;
 }
-    
\ No newline at end of file
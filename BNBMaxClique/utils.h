@@ -2,9 +2,83 @@
 #include <vector>
 #include <unordered_set>
 #include <tuple>
+#include <random>
+#include <string>
 
-std::tuple<int, std::vector<int>> GreedyGraphColoring(const std::vector<std::unordered_set<int>>& neighbour_sets, const std::vector<int>& vertices_order);
+enum class BnBEngine
+{
+    HashSets,
+    Bitset
+};
 
-std::vector<int> PardalosOrder(const std::vector<std::unordered_set<int>>& neighbour_sets);
+enum class ColoringMode
+{
+    // one greedy pass over all the candidates, every color class is branched on
+    Greedy,
+    // MCS: classes up to k_min are never branched on and Re-NUMBER tries to move vertices into them
+    Renumber
+};
 
-std::vector<int> SmallDegreeLastWithRemoveOrder(const std::vector<std::unordered_set<int>>& neighbour_sets);
+enum class PruningBound
+{
+    // a node is cut off when the clique together with the colors of its candidates can't beat the best clique
+    Coloring,
+    // when the coloring doesn't cut the node off, MaxSAT reasoning over the color classes (IncMaxCLQ) tries
+    // to remove vertices from branching
+    MaxSat
+};
+
+struct BnBOptions
+{
+    BnBEngine engine = BnBEngine::Bitset;
+    // threads are used by the bitset engine only, the hash-set recursion always runs on one thread
+    int threads = 1;
+    ColoringMode coloring = ColoringMode::Greedy;
+    // used by the bitset engine only
+    PruningBound bound = PruningBound::Coloring;
+    // the bitset engine runs the kernel compiled for the word count of the graph if there is one,
+    // false keeps it on the dynamic-width kernel
+    bool fixed_width = true;
+    // seed of the tabu search that finds the initial clique
+    unsigned seed = std::mt19937::default_seed;
+    // the search resumes from this file if it exists and saves its progress there, empty to disable
+    std::string checkpoint_file;
+    double checkpoint_interval = 60;
+};
+
+// buffers of ColorForBranching, sized once for the whole graph so that coloring a search node does not allocate
+struct ColoringScratch
+{
+    // color of every vertex, all of them are 0 between the calls
+    std::vector<int> colors;
+    std::vector<int> conflicts;
+    std::vector<int> conflict_vertex;
+    std::vector<int> moved_conflicts;
+    std::vector<int> class_start;
+
+    void Init(int vertices);
+};
+
+// a function to color the vertices greedily in the given order. The ones with a color above k_min are written to
+// branch_vertices and branch_colors grouped by ascending color; k_min = 0 gives the plain greedy coloring.
+// With renumber (MCS), before a vertex gets a color above k_min, Re-NUMBER looks for a class k1 <= k_min where it has
+// a single neighbour w that can move to another class k2 <= k_min
+void ColorForBranching(const std::vector<std::unordered_set<int>>& neighbour_sets, const std::vector<int>& vertices_order, int k_min, bool renumber,
+    ColoringScratch& scratch, std::vector<int>& branch_vertices, std::vector<int>& branch_colors);
+
+// the part of a graph that can still hold a clique larger than a given size
+struct CliqueKernel
+{
+    // the graph without the removed vertices and edges, in the original numbering. Removed vertices have no neighbours.
+    // Left empty if nothing was removed, then the kernel is the whole graph
+    std::vector<std::unordered_set<int>> neighbour_sets;
+    // vertices left, in ascending order
+    std::vector<int> vertices;
+    size_t edges = 0;
+};
+
+// a function to peel the graph down to what a clique of clique_size + 1 vertices can use: every vertex of it has
+// clique_size neighbours and every edge lies in clique_size - 1 triangles. Vertices of a smaller degree and edges of
+// a smaller triangle support are removed until nothing changes. The supports are counted with word-wise AND of the
+// adjacency rows, so this step is skipped when too many vertices are left after the degree peeling
+CliqueKernel ReduceForClique(const std::vector<std::unordered_set<int>>& neighbour_sets, int clique_size);
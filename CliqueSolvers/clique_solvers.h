@@ -0,0 +1,20 @@
+#pragma once
+// the solvers of the other projects as one static library. A graph is loaded once into a GraphHandle and every
+// solver takes it by const reference, the solvers keep a handle to the same graph instead of a copy:
+//
+//     GraphHandle graph = GraphHandle::LoadDimacs("brock200_1.clq");
+//     MaxCliqueTabuSearch tabu(graph);
+//     tabu.RunSearch(1000);
+//     BnBSolver exact(graph);
+//     exact.RunBnB(60);
+//
+// Solvers on the same graph can run on different threads at once, a single solver is not thread-safe.
+// The forms of the graph a solver needs besides the CSR rows (neighbour sets, complement, adjacency bitsets,
+// degeneracy order) are built by the first solver that asks for them and shared with the rest, and a solver reuses
+// its own buffers from one run to the next. The library prints nothing, results and diagnostics such as the reduced
+// graph or a checkpoint that couldn't be read come from getters of the solvers
+#include "../Common/graph_handle.h"
+#include "../GreedyColoring/graph_coloring.h"
+#include "../MaxClique/max_clique_problem.h"
+#include "../TabuMaxClique/tabu_max_clique.h"
+#include "../BNBMaxClique/bnb_solver.h"
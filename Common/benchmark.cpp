@@ -0,0 +1,534 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "benchmark.h"
+
+using namespace std;
+
+namespace
+{
+    vector<string> SplitList(const string& list)
+    {
+        vector<string> items;
+        stringstream ss(list);
+        string item;
+        while (getline(ss, item, ','))
+        {
+            if (!item.empty())
+            {
+                items.push_back(item);
+            }
+        }
+        return items;
+    }
+
+    string Trim(const string& text)
+    {
+        size_t first = text.find_first_not_of(" \t\r\"");
+        if (first == string::npos)
+        {
+            return "";
+        }
+        size_t last = text.find_last_not_of(" \t\r\"");
+        return text.substr(first, last - first + 1);
+    }
+
+    // splits a CSV line, commas inside double quotes don't separate fields
+    vector<string> SplitCsvLine(const string& line)
+    {
+        vector<string> fields(1);
+        bool quoted = false;
+        for (char c : line)
+        {
+            if (c == '"')
+            {
+                quoted = !quoted;
+            }
+            else if (c == ',' && !quoted)
+            {
+                fields.emplace_back();
+            }
+            else
+            {
+                fields.back() += c;
+            }
+        }
+        for (auto& field : fields)
+        {
+            field = Trim(field);
+        }
+        return fields;
+    }
+
+    string JsonString(const string& text)
+    {
+        string result = "\"";
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                result += '\\';
+            }
+            result += c;
+        }
+        return result + "\"";
+    }
+
+    string JsonEvents(const vector<ProfileEvent>& events)
+    {
+        stringstream ss;
+        ss << "[";
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            ss << (i ? ", " : "") << "[" << events[i].seconds << ", " << events[i].quality << "]";
+        }
+        ss << "]";
+        return ss.str();
+    }
+
+    // a CSV row per incumbent, the points of the anytime curves
+    template <typename Run>
+    void WriteAnytime(const string& path, const vector<Run>& runs)
+    {
+        ofstream fout(path);
+        fout << "File,Seed,Seconds,Quality\n";
+        for (const auto& run : runs)
+        {
+            for (const auto& event : run.profile.incumbents)
+            {
+                fout << run.file << "," << run.seed << "," << event.seconds << "," << event.quality << "\n";
+            }
+        }
+    }
+
+    void PrintUsage(const char* program)
+    {
+        cout << "Usage: " << program << " [--instances a,b,...] [--reps N] [--seeds s1,s2,...] [--json file]"
+            << " [--baseline file.csv] [--tolerance t] [--<parameter> value ...]\n";
+    }
+}
+
+int BenchmarkOptions::GetInt(const string& name, int default_value) const
+{
+    auto it = parameters.find(name);
+    return it == parameters.end() ? default_value : atoi(it->second.c_str());
+}
+
+double BenchmarkOptions::GetDouble(const string& name, double default_value) const
+{
+    auto it = parameters.find(name);
+    return it == parameters.end() ? default_value : atof(it->second.c_str());
+}
+
+string BenchmarkOptions::GetString(const string& name, const string& default_value) const
+{
+    auto it = parameters.find(name);
+    return it == parameters.end() ? default_value : it->second;
+}
+
+BenchmarkOptions ParseBenchmarkOptions(int argc, char* argv[], const vector<string>& default_files, unsigned default_seed)
+{
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i)
+    {
+        string name = argv[i];
+        if (name == "--help" || name == "-h")
+        {
+            PrintUsage(argv[0]);
+            exit(0);
+        }
+        if (name.size() < 3 || name.compare(0, 2, "--") != 0 || i + 1 >= argc)
+        {
+            cout << "Can't parse argument " << name << "\n";
+            PrintUsage(argv[0]);
+            exit(1);
+        }
+        name = name.substr(2);
+        string value = argv[++i];
+        if (name == "instances")
+        {
+            options.files = SplitList(value);
+        }
+        else if (name == "reps")
+        {
+            options.repetitions = max(1, atoi(value.c_str()));
+        }
+        else if (name == "seeds")
+        {
+            for (const auto& seed : SplitList(value))
+            {
+                options.seeds.push_back(strtoul(seed.c_str(), nullptr, 10));
+            }
+        }
+        else if (name == "json")
+        {
+            options.json_file = value;
+        }
+        else if (name == "baseline")
+        {
+            options.baseline_file = value;
+        }
+        else if (name == "tolerance")
+        {
+            options.tolerance = atof(value.c_str());
+        }
+        else
+        {
+            options.parameters[name] = value;
+        }
+    }
+    if (options.files.empty())
+    {
+        options.files = default_files;
+    }
+    if (options.seeds.empty())
+    {
+        options.seeds.push_back(default_seed);
+    }
+    return options;
+}
+
+BenchmarkTimer::BenchmarkTimer() : wall_start(chrono::steady_clock::now()), cpu_start(clock())
+{
+}
+
+double BenchmarkTimer::WallSeconds() const
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - wall_start).count();
+}
+
+double BenchmarkTimer::CpuSeconds() const
+{
+    return double(clock() - cpu_start) / CLOCKS_PER_SEC;
+}
+
+BenchmarkStatistics Summarize(vector<double> samples)
+{
+    BenchmarkStatistics statistics;
+    if (samples.empty())
+    {
+        return statistics;
+    }
+    sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+    statistics.min = samples[0];
+    statistics.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    statistics.p95 = samples[(size_t)ceil(0.95 * n) - 1];
+    return statistics;
+}
+
+BenchmarkReport::BenchmarkReport(const string& solver, const string& quality_column, QualityGoal goal,
+    const string& time_column, const BenchmarkOptions& options)
+    : solver(solver), quality_column(quality_column), goal(goal), time_column(time_column), options(options)
+{
+    // the solvers write their CSV to the default baseline file, so it has to be read before that file is opened
+    LoadBaseline();
+}
+
+void BenchmarkReport::AddRun(const string& file, unsigned seed, double wall_seconds, double cpu_seconds, int quality, bool valid)
+{
+    if (runs.count(file) == 0)
+    {
+        files.push_back(file);
+    }
+    runs[file].push_back({ seed, wall_seconds, cpu_seconds, quality, valid });
+}
+
+BenchmarkStatistics BenchmarkReport::WallStatistics(const string& file) const
+{
+    vector<double> samples;
+    auto it = runs.find(file);
+    if (it != runs.end())
+    {
+        for (const auto& run : it->second)
+        {
+            samples.push_back(run.wall_seconds);
+        }
+    }
+    return Summarize(samples);
+}
+
+bool BenchmarkReport::IsBetter(int quality, int other) const
+{
+    return goal == QualityGoal::Maximize ? quality > other : quality < other;
+}
+
+void BenchmarkReport::LoadBaseline()
+{
+    if (options.baseline_file.empty())
+    {
+        return;
+    }
+    ifstream fin(options.baseline_file);
+    string line;
+    if (!fin.is_open() || !getline(fin, line))
+    {
+        cout << "Can't read baseline file " << options.baseline_file << "\n";
+        return;
+    }
+    vector<string> header = SplitCsvLine(line);
+    int file_index = -1;
+    int quality_index = -1;
+    int time_index = -1;
+    for (int i = 0; i < header.size(); ++i)
+    {
+        if (header[i] == "File" || header[i] == "Instance")
+        {
+            file_index = i;
+        }
+        else if (header[i] == quality_column)
+        {
+            quality_index = i;
+        }
+        else if (header[i] == time_column)
+        {
+            time_index = i;
+        }
+    }
+    if (file_index < 0 || quality_index < 0)
+    {
+        cout << "Baseline file " << options.baseline_file << " has no instance or " << quality_column << " column\n";
+        return;
+    }
+    baseline_has_time = time_index >= 0;
+
+    while (getline(fin, line))
+    {
+        vector<string> fields = SplitCsvLine(line);
+        if (fields.size() <= max(file_index, quality_index))
+        {
+            continue;
+        }
+        Baseline& baseline = baselines[fields[file_index]];
+        baseline.found = true;
+        baseline.quality = atoi(fields[quality_index].c_str());
+        if (time_index >= 0 && time_index < fields.size())
+        {
+            baseline.time_seconds = atof(fields[time_index].c_str());
+        }
+    }
+}
+
+int BenchmarkReport::CompareWithBaseline()
+{
+    if (options.baseline_file.empty())
+    {
+        return 0;
+    }
+
+    int regressions = 0;
+    for (const auto& file : files)
+    {
+        auto it = baselines.find(file);
+        if (it == baselines.end())
+        {
+            continue;
+        }
+        Baseline& baseline = it->second;
+        // the worst run decides, a seed that loses quality is a regression even if others don't
+        int worst = runs[file][0].quality;
+        for (const auto& run : runs[file])
+        {
+            if (IsBetter(worst, run.quality))
+            {
+                worst = run.quality;
+            }
+        }
+        double median = WallStatistics(file).median;
+        if (IsBetter(baseline.quality, worst))
+        {
+            baseline.regression = "quality";
+            cout << "REGRESSION " << file << ": " << quality_column << " " << worst << ", baseline " << baseline.quality << "\n";
+            ++regressions;
+        }
+        else if (baseline_has_time && median > baseline.time_seconds * (1 + options.tolerance))
+        {
+            baseline.regression = "time";
+            cout << "REGRESSION " << file << ": median wall time " << median << " sec, baseline " << baseline.time_seconds << " sec\n";
+            ++regressions;
+        }
+    }
+    cout << regressions << " regressions against " << options.baseline_file << "\n";
+    return regressions;
+}
+
+void BenchmarkReport::WriteJson() const
+{
+    string path = options.json_file.empty() ? solver + "_benchmark.json" : options.json_file;
+    ofstream fout(path);
+    fout << "{\n";
+    fout << "  \"solver\": " << JsonString(solver) << ",\n";
+    fout << "  \"repetitions\": " << options.repetitions << ",\n";
+    fout << "  \"seeds\": [";
+    for (size_t i = 0; i < options.seeds.size(); ++i)
+    {
+        fout << (i ? ", " : "") << options.seeds[i];
+    }
+    fout << "],\n";
+    fout << "  \"parameters\": {";
+    bool first = true;
+    for (const auto& [name, value] : options.parameters)
+    {
+        fout << (first ? "" : ", ") << JsonString(name) << ": " << JsonString(value);
+        first = false;
+    }
+    fout << "},\n";
+    fout << "  \"quality\": " << JsonString(quality_column) << ",\n";
+    fout << "  \"instances\": [";
+    for (size_t f = 0; f < files.size(); ++f)
+    {
+        const auto& file = files[f];
+        const auto& file_runs = runs.at(file);
+        vector<double> wall;
+        vector<double> cpu;
+        int best = file_runs[0].quality;
+        int worst = file_runs[0].quality;
+        bool valid = true;
+        for (const auto& run : file_runs)
+        {
+            wall.push_back(run.wall_seconds);
+            cpu.push_back(run.cpu_seconds);
+            best = IsBetter(run.quality, best) ? run.quality : best;
+            worst = IsBetter(worst, run.quality) ? run.quality : worst;
+            valid = valid && run.valid;
+        }
+        auto wall_statistics = Summarize(wall);
+        auto cpu_statistics = Summarize(cpu);
+
+        fout << (f ? "," : "") << "\n    {\n";
+        fout << "      \"file\": " << JsonString(file) << ",\n";
+        fout << "      \"valid\": " << (valid ? "true" : "false") << ",\n";
+        fout << "      \"best_quality\": " << best << ",\n";
+        fout << "      \"worst_quality\": " << worst << ",\n";
+        fout << "      \"wall_sec\": {\"min\": " << wall_statistics.min << ", \"median\": " << wall_statistics.median << ", \"p95\": " << wall_statistics.p95 << "},\n";
+        fout << "      \"cpu_sec\": {\"min\": " << cpu_statistics.min << ", \"median\": " << cpu_statistics.median << ", \"p95\": " << cpu_statistics.p95 << "},\n";
+        auto baseline = baselines.find(file);
+        if (baseline != baselines.end())
+        {
+            fout << "      \"baseline\": {\"quality\": " << baseline->second.quality << ", \"time_sec\": " << baseline->second.time_seconds
+                << ", \"regression\": " << JsonString(baseline->second.regression) << "},\n";
+        }
+        fout << "      \"runs\": [";
+        for (size_t r = 0; r < file_runs.size(); ++r)
+        {
+            const auto& run = file_runs[r];
+            fout << (r ? ", " : "") << "{\"seed\": " << run.seed << ", \"wall_sec\": " << run.wall_seconds << ", \"cpu_sec\": " << run.cpu_seconds
+                << ", \"quality\": " << run.quality << ", \"valid\": " << (run.valid ? "true" : "false") << "}";
+        }
+        fout << "]\n    }";
+    }
+    fout << "\n  ]\n}\n";
+}
+
+ProfileReport::ProfileReport(const string& name) : name(name)
+{
+}
+
+void ProfileReport::AddRun(const string& file, unsigned seed, const BnBProfile& profile)
+{
+    bnb_runs.push_back({ file, seed, profile });
+}
+
+void ProfileReport::AddRun(const string& file, unsigned seed, const TabuProfile& profile)
+{
+    tabu_runs.push_back({ file, seed, profile });
+}
+
+void ProfileReport::Write() const
+{
+    if (name.empty())
+    {
+        return;
+    }
+    if (!SEARCH_PROFILE)
+    {
+        cout << "The solver was built with SEARCH_PROFILE=0, the profiles in " << name << ".json are empty\n";
+    }
+    if (!bnb_runs.empty())
+    {
+        WriteBnB();
+    }
+    if (!tabu_runs.empty())
+    {
+        WriteTabu();
+    }
+}
+
+void ProfileReport::WriteBnB() const
+{
+    ofstream json(name + ".json");
+    ofstream csv(name + ".csv");
+    json << "{\n  \"search\": \"bnb\",\n  \"runs\": [";
+    csv << "File,Seed,Nodes,Max depth,Coloring prunes,Search time (sec),Thread time (sec),Coloring time (sec),Branching time (sec),Improvements,Time to best (sec)\n";
+    for (size_t r = 0; r < bnb_runs.size(); ++r)
+    {
+        const auto& run = bnb_runs[r];
+        const BnBProfile& profile = run.profile;
+        long long nodes = 0;
+        for (long long depth_nodes : profile.depth_nodes)
+        {
+            nodes += depth_nodes;
+        }
+        double branching_seconds = max(0.0, profile.thread_seconds - profile.coloring_seconds);
+
+        json << (r ? "," : "") << "\n    {\n";
+        json << "      \"file\": " << JsonString(run.file) << ",\n";
+        json << "      \"seed\": " << run.seed << ",\n";
+        json << "      \"nodes\": " << nodes << ",\n";
+        json << "      \"depth_nodes\": [";
+        for (size_t depth = 0; depth < profile.depth_nodes.size(); ++depth)
+        {
+            json << (depth ? ", " : "") << profile.depth_nodes[depth];
+        }
+        json << "],\n";
+        json << "      \"coloring_prunes\": " << profile.coloring_prunes << ",\n";
+        json << "      \"search_sec\": " << profile.search_seconds << ",\n";
+        json << "      \"thread_sec\": " << profile.thread_seconds << ",\n";
+        json << "      \"coloring_sec\": " << profile.coloring_seconds << ",\n";
+        json << "      \"branching_sec\": " << branching_seconds << ",\n";
+        json << "      \"incumbents\": " << JsonEvents(profile.incumbents) << "\n    }";
+
+        csv << run.file << "," << run.seed << "," << nodes << "," << profile.depth_nodes.size() << "," << profile.coloring_prunes << ","
+            << profile.search_seconds << "," << profile.thread_seconds << "," << profile.coloring_seconds << "," << branching_seconds << ","
+            << profile.incumbents.size() << "," << profile.TimeToBest() << "\n";
+    }
+    json << "\n  ]\n}\n";
+    WriteAnytime(name + "_anytime.csv", bnb_runs);
+}
+
+void ProfileReport::WriteTabu() const
+{
+    ofstream json(name + ".json");
+    ofstream csv(name + ".csv");
+    json << "{\n  \"search\": \"tabu\",\n  \"runs\": [";
+    csv << "File,Seed,Moves,Swaps,Destroys,Search time (sec),Moves per sec,Swaps per sec,Destroys per sec,Improvements,Time to best (sec)\n";
+    for (size_t r = 0; r < tabu_runs.size(); ++r)
+    {
+        const auto& run = tabu_runs[r];
+        const TabuProfile& profile = run.profile;
+        double seconds = profile.search_seconds > 0 ? profile.search_seconds : 1;
+
+        json << (r ? "," : "") << "\n    {\n";
+        json << "      \"file\": " << JsonString(run.file) << ",\n";
+        json << "      \"seed\": " << run.seed << ",\n";
+        json << "      \"moves\": " << profile.moves << ",\n";
+        json << "      \"swaps\": " << profile.swaps << ",\n";
+        json << "      \"destroys\": " << profile.destroys << ",\n";
+        json << "      \"search_sec\": " << profile.search_seconds << ",\n";
+        json << "      \"moves_per_sec\": " << profile.moves / seconds << ",\n";
+        json << "      \"swaps_per_sec\": " << profile.swaps / seconds << ",\n";
+        json << "      \"destroys_per_sec\": " << profile.destroys / seconds << ",\n";
+        json << "      \"time_to_best_sec\": " << profile.TimeToBest() << ",\n";
+        json << "      \"incumbents\": " << JsonEvents(profile.incumbents) << "\n    }";
+
+        csv << run.file << "," << run.seed << "," << profile.moves << "," << profile.swaps << "," << profile.destroys << ","
+            << profile.search_seconds << "," << profile.moves / seconds << "," << profile.swaps / seconds << "," << profile.destroys / seconds << ","
+            << profile.incumbents.size() << "," << profile.TimeToBest() << "\n";
+    }
+    json << "\n  ]\n}\n";
+    WriteAnytime(name + "_anytime.csv", tabu_runs);
+}
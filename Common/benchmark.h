@@ -0,0 +1,151 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <time.h>
+
+#include "search_profile.h"
+
+// command line of a solver: --instances a,b,c --reps N --seeds s1,s2 --json file --baseline file --tolerance t,
+// every other "--name value" pair is a parameter of the solver itself
+struct BenchmarkOptions
+{
+    std::vector<std::string> files;
+    int repetitions = 1;
+    std::vector<unsigned> seeds;
+    std::string json_file;
+    std::string baseline_file;
+    // a median wall time this much slower than the baseline (relative) counts as a regression
+    double tolerance = 0.1;
+    std::map<std::string, std::string> parameters;
+
+    int GetInt(const std::string& name, int default_value) const;
+
+    double GetDouble(const std::string& name, double default_value) const;
+
+    std::string GetString(const std::string& name, const std::string& default_value) const;
+};
+
+// a function to parse the command line, the files and the seeds fall back to the given defaults.
+// Prints the usage and exits on a malformed argument
+BenchmarkOptions ParseBenchmarkOptions(int argc, char* argv[], const std::vector<std::string>& default_files, unsigned default_seed);
+
+// wall-clock time from steady_clock and CPU time of the whole process from clock(), both in seconds
+class BenchmarkTimer
+{
+public:
+    BenchmarkTimer();
+
+    double WallSeconds() const;
+
+    double CpuSeconds() const;
+
+private:
+    std::chrono::steady_clock::time_point wall_start;
+    clock_t cpu_start;
+};
+
+struct BenchmarkStatistics
+{
+    double min = 0;
+    double median = 0;
+    double p95 = 0;
+};
+
+// min, median and nearest-rank 95th percentile of the samples
+BenchmarkStatistics Summarize(std::vector<double> samples);
+
+enum class QualityGoal
+{
+    Maximize,
+    Minimize
+};
+
+// collects the runs of every instance, writes them to JSON and compares them with a CSV the solver wrote before.
+// Quality is the clique size or the number of colors, goal tells which direction is better
+class BenchmarkReport
+{
+public:
+    BenchmarkReport(const std::string& solver, const std::string& quality_column, QualityGoal goal,
+        const std::string& time_column, const BenchmarkOptions& options);
+
+    void AddRun(const std::string& file, unsigned seed, double wall_seconds, double cpu_seconds, int quality, bool valid);
+
+    BenchmarkStatistics WallStatistics(const std::string& file) const;
+
+    // true if the first quality is better than the second one
+    bool IsBetter(int quality, int other) const;
+
+    // prints every instance that got a worse quality or a slower median wall time than in the baseline CSV,
+    // if one was given. Returns the number of regressions
+    int CompareWithBaseline();
+
+    // writes the runs to options.json_file, or to <solver>_benchmark.json if it is empty
+    void WriteJson() const;
+
+private:
+    struct Run
+    {
+        unsigned seed;
+        double wall_seconds;
+        double cpu_seconds;
+        int quality;
+        bool valid;
+    };
+
+    struct Baseline
+    {
+        bool found = false;
+        int quality = 0;
+        double time_seconds = 0;
+        std::string regression = "none";
+    };
+
+    std::string solver;
+    std::string quality_column;
+    QualityGoal goal;
+    std::string time_column;
+    BenchmarkOptions options;
+    // instances in the order of their first run
+    std::vector<std::string> files;
+    std::map<std::string, std::vector<Run>> runs;
+    std::map<std::string, Baseline> baselines;
+    bool baseline_has_time = false;
+
+    // reads the rows of the baseline CSV, the constructor calls it before the solver opens its own output
+    void LoadBaseline();
+};
+
+// collects the search profiles of the runs and writes them for plotting: <name>.json has everything,
+// <name>.csv a row of totals per run and <name>_anytime.csv the incumbents of every run.
+// A report holds the profiles of one kind of search
+class ProfileReport
+{
+public:
+    // nothing is written if the name is empty
+    explicit ProfileReport(const std::string& name);
+
+    void AddRun(const std::string& file, unsigned seed, const BnBProfile& profile);
+
+    void AddRun(const std::string& file, unsigned seed, const TabuProfile& profile);
+
+    void Write() const;
+
+private:
+    template <typename Profile>
+    struct Run
+    {
+        std::string file;
+        unsigned seed;
+        Profile profile;
+    };
+
+    std::string name;
+    std::vector<Run<BnBProfile>> bnb_runs;
+    std::vector<Run<TabuProfile>> tabu_runs;
+
+    void WriteBnB() const;
+
+    void WriteTabu() const;
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using Word = std::uint64_t;
+
+const int kWordBits = 64;
+
+inline int WordsFor(int bits)
+{
+    return (bits + kWordBits - 1) / kWordBits;
+}
+
+inline int PopCount(Word word)
+{
+#ifdef _MSC_VER
+    return (int)__popcnt64(word);
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+// index of the lowest set bit, word must not be zero
+inline int LowestBit(Word word)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return (int)index;
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+// index of the lowest zero bit among the given words, words * kWordBits if every bit is set
+inline int FirstZeroBit(const Word* bits, int words)
+{
+    for (int w = 0; w < words; ++w)
+    {
+        if (~bits[w] != 0)
+        {
+            return w * kWordBits + LowestBit(~bits[w]);
+        }
+    }
+    return words * kWordBits;
+}
+
+// index of the k-th lowest set bit counting from 0, the word must have more than k set bits
+inline int SelectBit(Word word, int k)
+{
+    for (; k > 0; --k)
+    {
+        word &= word - 1;
+    }
+    return LowestBit(word);
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+
+#include "dimacs_loader.h"
+
+// a function to build the complement of a graph in compressed sparse row form, the non-neighbours of every
+// vertex come out sorted. Graph is anything with size() and operator[] giving an iterable list of neighbours.
+// Takes O(V^2) time and memory proportional to the number of non-edges
+template <typename Graph>
+CsrGraph ComplementGraph(const Graph& graph)
+{
+    int vertices = graph.size();
+    CsrGraph complement;
+    complement.offsets.resize(vertices + 1, 0);
+    size_t non_edges = 0;
+    for (int v = 0; v < vertices; ++v)
+    {
+        non_edges += vertices - 1 - graph[v].size();
+    }
+    complement.adjacency.reserve(non_edges);
+
+    // neighbours of the current vertex are marked with its number plus one
+    std::vector<int> mark(vertices, 0);
+    for (int v = 0; v < vertices; ++v)
+    {
+        for (int neighbour : graph[v])
+        {
+            mark[neighbour] = v + 1;
+        }
+        for (int u = 0; u < vertices; ++u)
+        {
+            if (u != v && mark[u] != v + 1)
+            {
+                complement.adjacency.push_back(u);
+            }
+        }
+        complement.offsets[v + 1] = complement.adjacency.size();
+    }
+    return complement;
+}
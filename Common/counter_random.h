@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+
+// a counter-based random generator: the n-th number of a stream is SplitMix64 of the stream key plus n, so every
+// stream is fixed by (seed, stream) alone and can be run on any thread in any order. Works with the std distributions
+class CounterRandom
+{
+public:
+    using result_type = std::uint64_t;
+
+    CounterRandom(std::uint64_t seed, std::uint64_t stream) : key(Mix(Mix(seed) + stream))
+    {
+    }
+
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    static constexpr result_type max()
+    {
+        return ~result_type(0);
+    }
+
+    result_type operator()()
+    {
+        return Mix(key + ++counter * kGamma);
+    }
+
+private:
+    static const std::uint64_t kGamma = 0x9e3779b97f4a7c15ull;
+
+    std::uint64_t key;
+    std::uint64_t counter = 0;
+
+    static std::uint64_t Mix(std::uint64_t z)
+    {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+};
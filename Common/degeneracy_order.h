@@ -0,0 +1,103 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+struct DegeneracyOrder
+{
+    // vertices in the order they are removed, each one has the smallest degree in the rest of the graph
+    std::vector<int> order;
+    // core number of every vertex, the largest degree seen at removal up to and including that vertex
+    std::vector<int> core_numbers;
+    // the largest core number
+    int degeneracy = 0;
+};
+
+// a function to implement "small degree with remove" with a bucket queue. Graph is anything with size() and
+// operator[] giving an iterable list of neighbours, like std::vector<std::unordered_set<int>> or CsrGraph.
+// Among the vertices of the smallest remaining degree the one with the smallest number is removed, so the order
+// depends only on the graph and not on the order the neighbours are listed in. Every bucket is a min-heap of
+// vertices, a vertex that moves down a bucket is pushed to the new one and its old entry is skipped when it comes
+// to the top, which takes O((V + E) log V)
+template <typename Graph>
+DegeneracyOrder ComputeDegeneracyOrder(const Graph& graph)
+{
+    int vertices = graph.size();
+    DegeneracyOrder result;
+    result.order.reserve(vertices);
+    result.core_numbers.resize(vertices);
+
+    std::vector<int> degree(vertices);
+    int max_degree = 0;
+    for (int v = 0; v < vertices; ++v)
+    {
+        degree[v] = graph[v].size();
+        if (degree[v] > max_degree)
+        {
+            max_degree = degree[v];
+        }
+    }
+
+    // the degree only goes down, so a vertex enters every bucket at most once
+    std::vector<std::vector<int>> buckets(max_degree + 1);
+    std::vector<bool> removed(vertices, false);
+    auto push = [&](int vertex)
+    {
+        std::vector<int>& bucket = buckets[degree[vertex]];
+        bucket.push_back(vertex);
+        std::push_heap(bucket.begin(), bucket.end(), std::greater<int>());
+    };
+    // vertices come in ascending order, so every bucket is a heap already
+    for (int v = 0; v < vertices; ++v)
+    {
+        buckets[degree[v]].push_back(v);
+    }
+
+    int min_degree = 0;
+    int core = 0;
+    for (int i = 0; i < vertices; ++i)
+    {
+        int vertex = -1;
+        while (vertex < 0)
+        {
+            std::vector<int>& bucket = buckets[min_degree];
+            while (!bucket.empty() && (removed[bucket.front()] || degree[bucket.front()] != min_degree))
+            {
+                std::pop_heap(bucket.begin(), bucket.end(), std::greater<int>());
+                bucket.pop_back();
+            }
+            if (bucket.empty())
+            {
+                ++min_degree;
+                continue;
+            }
+            vertex = bucket.front();
+            std::pop_heap(bucket.begin(), bucket.end(), std::greater<int>());
+            bucket.pop_back();
+        }
+        removed[vertex] = true;
+        result.order.push_back(vertex);
+        if (degree[vertex] > core)
+        {
+            core = degree[vertex];
+        }
+        result.core_numbers[vertex] = core;
+
+        // everytime we remove a vertex its neighbours move one bucket down
+        for (int neighbour : graph[vertex])
+        {
+            if (!removed[neighbour])
+            {
+                --degree[neighbour];
+                push(neighbour);
+            }
+        }
+        // a neighbour can end up one bucket below the removed vertex at most
+        if (min_degree > 0)
+        {
+            --min_degree;
+        }
+    }
+    result.degeneracy = core;
+    return result;
+}
@@ -0,0 +1,287 @@
+#include <algorithm>
+#include <utility>
+#include <climits>
+#include <random>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "dimacs_loader.h"
+
+using namespace std;
+
+namespace
+{
+    // read-only mapping of a whole file, unmapped when it goes out of scope
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const string& filename)
+        {
+#ifdef _WIN32
+            file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                return;
+            }
+            LARGE_INTEGER file_size;
+            if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+            {
+                return;
+            }
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping == nullptr)
+            {
+                return;
+            }
+            data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if (data != nullptr)
+            {
+                size = (size_t)file_size.QuadPart;
+            }
+#else
+            descriptor = open(filename.c_str(), O_RDONLY);
+            if (descriptor < 0)
+            {
+                return;
+            }
+            struct stat file_stat;
+            if (fstat(descriptor, &file_stat) != 0 || file_stat.st_size == 0)
+            {
+                return;
+            }
+            void* address = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (address != MAP_FAILED)
+            {
+                data = static_cast<const char*>(address);
+                size = file_stat.st_size;
+                madvise(address, size, MADV_SEQUENTIAL);
+            }
+#endif
+        }
+
+        ~MappedFile()
+        {
+#ifdef _WIN32
+            if (data != nullptr)
+            {
+                UnmapViewOfFile(data);
+            }
+            if (mapping != nullptr)
+            {
+                CloseHandle(mapping);
+            }
+            if (file != INVALID_HANDLE_VALUE)
+            {
+                CloseHandle(file);
+            }
+#else
+            if (data != nullptr)
+            {
+                munmap(const_cast<char*>(data), size);
+            }
+            if (descriptor >= 0)
+            {
+                close(descriptor);
+            }
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data = nullptr;
+        size_t size = 0;
+
+    private:
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+#else
+        int descriptor = -1;
+#endif
+    };
+
+    bool IsDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    // skips everything up to the next number on the current line, returns false if the line ends first
+    bool ParseNumber(const char*& position, const char* end, long long& value)
+    {
+        while (position < end && *position != '\n' && !IsDigit(*position))
+        {
+            ++position;
+        }
+        if (position == end || *position == '\n')
+        {
+            return false;
+        }
+        value = 0;
+        while (position < end && IsDigit(*position))
+        {
+            value = value * 10 + (*position - '0');
+            ++position;
+        }
+        return true;
+    }
+
+    void SkipLine(const char*& position, const char* end)
+    {
+        while (position < end && *position != '\n')
+        {
+            ++position;
+        }
+        if (position < end)
+        {
+            ++position;
+        }
+    }
+
+    // loops have to be dropped by the caller, the edges are freed once they are in the rows
+    CsrGraph BuildCsr(long long vertices, vector<pair<int, int>>& edges)
+    {
+        CsrGraph graph;
+        // counting sort of both directions of every edge into the rows
+        graph.offsets.assign(vertices + 1, 0);
+        for (const auto& [start, finish] : edges)
+        {
+            ++graph.offsets[start + 1];
+            ++graph.offsets[finish + 1];
+        }
+        for (long long v = 0; v < vertices; ++v)
+        {
+            graph.offsets[v + 1] += graph.offsets[v];
+        }
+        graph.adjacency.resize(graph.offsets[vertices]);
+        vector<size_t> fill(graph.offsets.begin(), graph.offsets.end() - 1);
+        for (const auto& [start, finish] : edges)
+        {
+            graph.adjacency[fill[start]++] = finish;
+            graph.adjacency[fill[finish]++] = start;
+        }
+        edges.clear();
+        edges.shrink_to_fit();
+
+        // edges in the files can be repeated, so every row is sorted and compacted in place
+        size_t write = 0;
+        size_t row_start = 0;
+        for (long long v = 0; v < vertices; ++v)
+        {
+            size_t row_end = graph.offsets[v + 1];
+            auto first = graph.adjacency.begin() + row_start;
+            auto last = graph.adjacency.begin() + row_end;
+            sort(first, last);
+            last = unique(first, last);
+            graph.offsets[v] = write;
+            for (auto it = first; it != last; ++it)
+            {
+                graph.adjacency[write++] = *it;
+            }
+            row_start = row_end;
+        }
+        graph.offsets[vertices] = write;
+        graph.adjacency.resize(write);
+        graph.adjacency.shrink_to_fit();
+        return graph;
+    }
+}
+
+CsrGraph LoadDimacsGraph(const string& filename)
+{
+    CsrGraph graph;
+    MappedFile file(filename);
+    if (file.data == nullptr)
+    {
+        return graph;
+    }
+
+    const char* position = file.data;
+    const char* end = file.data + file.size;
+    long long vertices = 0;
+    vector<pair<int, int>> edges;
+    while (position < end)
+    {
+        char command = *position;
+        if (command == 'p')
+        {
+            // "p edge <vertices> <edges>", the format word has no digits in it
+            long long edge_count = 0;
+            ++position;
+            if (ParseNumber(position, end, vertices) && ParseNumber(position, end, edge_count))
+            {
+                edges.reserve(edge_count);
+            }
+        }
+        else if (command == 'e')
+        {
+            long long start, finish;
+            ++position;
+            if (ParseNumber(position, end, start) && ParseNumber(position, end, finish)
+                && start != finish && start >= 1 && finish >= 1 && start <= vertices && finish <= vertices)
+            {
+                edges.emplace_back(int(start - 1), int(finish - 1));
+            }
+        }
+        SkipLine(position, end);
+    }
+    return BuildCsr(vertices, edges);
+}
+
+CsrGraph LoadEdgeListGraph(const string& filename)
+{
+    MappedFile file(filename);
+    if (file.data == nullptr)
+    {
+        return CsrGraph();
+    }
+
+    const char* position = file.data;
+    const char* end = file.data + file.size;
+    long long vertices = 0;
+    vector<pair<int, int>> edges;
+    // a rough guess of the edge count, a line takes at least 4 characters
+    edges.reserve(file.size / 16);
+    while (position < end)
+    {
+        long long start, finish;
+        if (*position != '#' && *position != '%' && ParseNumber(position, end, start) && ParseNumber(position, end, finish)
+            && start != finish && max(start, finish) < INT_MAX)
+        {
+            edges.emplace_back(int(start), int(finish));
+            vertices = max(vertices, max(start, finish) + 1);
+        }
+        SkipLine(position, end);
+    }
+    return BuildCsr(vertices, edges);
+}
+
+CsrGraph GenerateRandomGraph(int vertices, long long edges, unsigned seed)
+{
+    vector<pair<int, int>> pairs;
+    if (vertices >= 2)
+    {
+        mt19937_64 generator(seed);
+        uniform_int_distribution<int> uniform(0, vertices - 1);
+        pairs.reserve(edges);
+        while (pairs.size() < edges)
+        {
+            int start = uniform(generator);
+            int finish = uniform(generator);
+            if (start != finish)
+            {
+                pairs.emplace_back(start, finish);
+            }
+        }
+    }
+    return BuildCsr(max(vertices, 0), pairs);
+}
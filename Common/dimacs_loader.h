@@ -0,0 +1,56 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstddef>
+
+// a read-only view of the neighbours of one vertex, can be used in range-based for loops
+class NeighbourRange
+{
+public:
+    NeighbourRange(const int* first, const int* last) : first(first), last(last) {}
+
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    size_t size() const { return last - first; }
+
+private:
+    const int* first;
+    const int* last;
+};
+
+// graph in compressed sparse row form: the neighbours of vertex v are
+// adjacency[offsets[v]] ... adjacency[offsets[v + 1] - 1], sorted and without duplicates
+struct CsrGraph
+{
+    std::vector<size_t> offsets;
+    std::vector<int> adjacency;
+
+    int size() const
+    {
+        return offsets.empty() ? 0 : (int)offsets.size() - 1;
+    }
+
+    size_t EdgeCount() const
+    {
+        return adjacency.size() / 2;
+    }
+
+    NeighbourRange operator[](int vertex) const
+    {
+        return NeighbourRange(adjacency.data() + offsets[vertex], adjacency.data() + offsets[vertex + 1]);
+    }
+};
+
+// a function to parse files in DIMACS format: 'c' lines are comments, the 'p' line gives the number of vertices
+// and every 'e' line is an edge with 1-based ends. The file is mapped into memory and parsed without iostreams,
+// repeated edges and loops are dropped. Returns an empty graph if the file can't be read
+CsrGraph LoadDimacsGraph(const std::string& filename);
+
+// a function to parse edge lists like the SNAP ones: every line is an edge given by two 0-based vertex numbers,
+// lines starting with '#' or '%' are comments. The number of vertices is the largest vertex + 1, repeated edges
+// and loops are dropped. Returns an empty graph if the file can't be read
+CsrGraph LoadEdgeListGraph(const std::string& filename);
+
+// a function to generate a G(n, m) random graph: every edge joins two vertices drawn uniformly at random. Repeated
+// pairs are dropped, so a graph with edges close to n^2 / 2 gets fewer of them. The same seed gives the same graph
+CsrGraph GenerateRandomGraph(int vertices, long long edges, unsigned seed);
@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <utility>
+
+#include "graph_handle.h"
+#include "complement_graph.h"
+
+using namespace std;
+
+GraphHandle::GraphHandle() : data(make_shared<Data>())
+{
+}
+
+GraphHandle::GraphHandle(CsrGraph graph) : data(make_shared<Data>())
+{
+    data->graph = move(graph);
+}
+
+GraphHandle GraphHandle::LoadDimacs(const string& filename)
+{
+    return GraphHandle(LoadDimacsGraph(filename));
+}
+
+GraphHandle GraphHandle::LoadEdgeList(const string& filename)
+{
+    return GraphHandle(LoadEdgeListGraph(filename));
+}
+
+bool GraphHandle::IsAdjacent(int a, int b) const
+{
+    NeighbourRange row = data->graph[a];
+    return binary_search(row.begin(), row.end(), b);
+}
+
+const vector<unordered_set<int>>& GraphHandle::NeighbourSets() const
+{
+    call_once(data->sets_built, [this]
+    {
+        const CsrGraph& graph = data->graph;
+        data->neighbour_sets.resize(graph.size());
+        for (int i = 0; i < graph.size(); ++i)
+        {
+            data->neighbour_sets[i].reserve(graph[i].size());
+            data->neighbour_sets[i].insert(graph[i].begin(), graph[i].end());
+        }
+    });
+    return data->neighbour_sets;
+}
+
+const CsrGraph& GraphHandle::NonNeighbours() const
+{
+    call_once(data->complement_built, [this] { data->non_neighbours = ComplementGraph(data->graph); });
+    return data->non_neighbours;
+}
+
+const vector<Word>& GraphHandle::AdjacencyRows() const
+{
+    call_once(data->rows_built, [this]
+    {
+        const CsrGraph& graph = data->graph;
+        int words = Words();
+        data->adjacency_rows.assign((size_t)graph.size() * words, 0);
+        for (int i = 0; i < graph.size(); ++i)
+        {
+            for (int j : graph[i])
+            {
+                data->adjacency_rows[(size_t)i * words + j / kWordBits] |= Word(1) << (j % kWordBits);
+            }
+        }
+    });
+    return data->adjacency_rows;
+}
+
+const DegeneracyOrder& GraphHandle::Degeneracy() const
+{
+    call_once(data->degeneracy_built, [this] { data->degeneracy = ComputeDegeneracyOrder(data->graph); });
+    return data->degeneracy;
+}
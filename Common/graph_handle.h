@@ -0,0 +1,85 @@
+#pragma once
+#include <vector>
+#include <unordered_set>
+#include <string>
+#include <memory>
+#include <mutex>
+
+#include "bit_ops.h"
+#include "degeneracy_order.h"
+#include "dimacs_loader.h"
+
+// a graph loaded once and shared by any number of solvers, threads and queries. Copies of a handle share the same
+// graph and nothing can change it after loading, so solvers take it by const reference and keep a handle instead
+// of a copy. The other forms of the graph the solvers use are built the first time one of them asks for it and kept
+// with the graph, later queries get them for free
+class GraphHandle
+{
+public:
+    // an empty graph
+    GraphHandle();
+
+    explicit GraphHandle(CsrGraph graph);
+
+    // see LoadDimacsGraph and LoadEdgeListGraph, the graph is empty if the file can't be read
+    static GraphHandle LoadDimacs(const std::string& filename);
+
+    static GraphHandle LoadEdgeList(const std::string& filename);
+
+    int size() const
+    {
+        return data->graph.size();
+    }
+
+    size_t EdgeCount() const
+    {
+        return data->graph.EdgeCount();
+    }
+
+    NeighbourRange operator[](int vertex) const
+    {
+        return data->graph[vertex];
+    }
+
+    const CsrGraph& Csr() const
+    {
+        return data->graph;
+    }
+
+    // binary search in the row of a
+    bool IsAdjacent(int a, int b) const;
+
+    // neighbours of every vertex as hash sets
+    const std::vector<std::unordered_set<int>>& NeighbourSets() const;
+
+    // non-neighbours of every vertex, sorted. The first call takes O(V^2) time
+    const CsrGraph& NonNeighbours() const;
+
+    // adjacency rows as bitsets of Words() words, the row of vertex v starts at v * Words(). They take V^2 / 8 bytes
+    const std::vector<Word>& AdjacencyRows() const;
+
+    int Words() const
+    {
+        return WordsFor(size());
+    }
+
+    // order, core numbers and degeneracy of the smallest-last ordering, see ComputeDegeneracyOrder
+    const DegeneracyOrder& Degeneracy() const;
+
+private:
+    // every lazy form has a flag, so two threads asking for it at once build it only once
+    struct Data
+    {
+        CsrGraph graph;
+        std::once_flag sets_built;
+        std::vector<std::unordered_set<int>> neighbour_sets;
+        std::once_flag complement_built;
+        CsrGraph non_neighbours;
+        std::once_flag rows_built;
+        std::vector<Word> adjacency_rows;
+        std::once_flag degeneracy_built;
+        DegeneracyOrder degeneracy;
+    };
+
+    std::shared_ptr<Data> data;
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include <vector>
+
+#include "bit_ops.h"
+
+// candidates of a greedy clique construction kept as bits of their positions in a fixed vertex order: bit i stands
+// for order[i], so the candidates stay in that order and the k-th of them is found by counting bits. Keeping only
+// the neighbours of a picked vertex is one AND with its adjacency row. The rows take V^2 / 8 bytes
+class OrderedCandidates
+{
+public:
+    // Graph is anything with size() and operator[] giving an iterable list of neighbours
+    template <typename Graph>
+    void Init(const Graph& graph, const std::vector<int>& vertex_order)
+    {
+        order = vertex_order;
+        int vertices = order.size();
+        words = WordsFor(vertices);
+        std::vector<int> position(graph.size(), -1);
+        for (int i = 0; i < vertices; ++i)
+        {
+            position[order[i]] = i;
+        }
+        rows.assign((size_t)vertices * words, 0);
+        for (int i = 0; i < vertices; ++i)
+        {
+            Word* row = &rows[(size_t)i * words];
+            for (int neighbour : graph[order[i]])
+            {
+                int j = position[neighbour];
+                if (j >= 0)
+                {
+                    row[j / kWordBits] |= Word(1) << (j % kWordBits);
+                }
+            }
+        }
+        candidates.assign(words, 0);
+        count = 0;
+    }
+
+    // every vertex of the order becomes a candidate
+    void Reset()
+    {
+        int vertices = order.size();
+        for (int w = 0; w < words; ++w)
+        {
+            candidates[w] = ~Word(0);
+        }
+        if (vertices % kWordBits != 0)
+        {
+            candidates[words - 1] = (Word(1) << (vertices % kWordBits)) - 1;
+        }
+        count = vertices;
+    }
+
+    int Size() const
+    {
+        return count;
+    }
+
+    bool Empty() const
+    {
+        return count == 0;
+    }
+
+    // a function to pick the index-th candidate in the order, the candidates that are not its neighbours are dropped
+    // together with it. Returns the vertex
+    int Take(int index)
+    {
+        int w = 0;
+        for (int in_word = PopCount(candidates[w]); index >= in_word; in_word = PopCount(candidates[++w]))
+        {
+            index -= in_word;
+        }
+        int position = w * kWordBits + SelectBit(candidates[w], index);
+
+        const Word* row = &rows[(size_t)position * words];
+        count = 0;
+        for (int i = 0; i < words; ++i)
+        {
+            candidates[i] &= row[i];
+            count += PopCount(candidates[i]);
+        }
+        return order[position];
+    }
+
+private:
+    std::vector<int> order;
+    int words = 0;
+    std::vector<Word> rows;
+    std::vector<Word> candidates;
+    int count = 0;
+};
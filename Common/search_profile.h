@@ -0,0 +1,218 @@
+#pragma once
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+// Counters of where a search spends its time. Every recording call is a small inline function, building with
+// SEARCH_PROFILE=0 leaves them empty, so the search pays nothing for them and the exported profiles are zeros
+#ifndef SEARCH_PROFILE
+#define SEARCH_PROFILE 1
+#endif
+
+// a point of an anytime curve: the best solution so far and the seconds since the run started
+struct ProfileEvent
+{
+    double seconds;
+    int quality;
+};
+
+// seconds since a start point, the clock is read only if the profile is compiled in
+class ProfileClock
+{
+public:
+    void Start()
+    {
+#if SEARCH_PROFILE
+        start = std::chrono::steady_clock::now();
+#endif
+    }
+
+    double Seconds() const
+    {
+#if SEARCH_PROFILE
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+#else
+        return 0;
+#endif
+    }
+
+    // what Start and Seconds add to a measured interval by themselves, the least of a few empty measurements
+    static double Overhead()
+    {
+        static const double overhead = []
+        {
+            double least = 1;
+            for (int i = 0; i < 100; ++i)
+            {
+                ProfileClock clock;
+                clock.Start();
+                least = std::min(least, clock.Seconds());
+            }
+            return least;
+        }();
+        return overhead;
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+// a run of a branch and bound search. Threads of a search keep their own and merge them at the end
+struct BnBProfile
+{
+    // coloring is timed at one node in this many and the time is scaled up, reading the clock twice at
+    // every node costs as much as coloring the small ones. Must be a power of two
+    static const long long kColoringSample = 64;
+
+    // nodes at every depth, depth 0 holds the top-level vertices
+    std::vector<long long> depth_nodes;
+    // children that were not expanded because the coloring bound couldn't beat the best clique
+    long long coloring_prunes = 0;
+    // wall time of the search, the time its threads spent in it summed over them and the part of that spent
+    // coloring the candidates. The rest goes into branching: building the child candidates, the MaxSAT bound
+    // and the recursion itself
+    double search_seconds = 0;
+    double thread_seconds = 0;
+    double coloring_seconds = 0;
+    // every improvement of the best clique, BnBSolver starts the list with the clique of its heuristic
+    std::vector<ProfileEvent> incumbents;
+
+    // makes room for the nodes down to this depth and for this many more incumbents, a search that calls it
+    // beforehand doesn't allocate in CountNode or RecordIncumbent
+    void Reserve(int max_depth, int incumbent_count)
+    {
+#if SEARCH_PROFILE
+        if (max_depth >= (int)depth_nodes.size())
+        {
+            depth_nodes.resize(max_depth + 1, 0);
+        }
+        incumbents.reserve(incumbents.size() + incumbent_count);
+#endif
+    }
+
+    void CountNode(int depth)
+    {
+#if SEARCH_PROFILE
+        if (depth >= (int)depth_nodes.size())
+        {
+            depth_nodes.resize(depth + 1, 0);
+        }
+        ++depth_nodes[depth];
+#endif
+    }
+
+    void CountColoringPrunes(long long children)
+    {
+#if SEARCH_PROFILE
+        coloring_prunes += children;
+#endif
+    }
+
+    void AddThreadTime(double seconds)
+    {
+#if SEARCH_PROFILE
+        thread_seconds += seconds;
+#endif
+    }
+
+    // true if the coloring of the node with this number is timed
+    bool SamplesColoring(long long node) const
+    {
+        return SEARCH_PROFILE && (node & (kColoringSample - 1)) == 0;
+    }
+
+    void AddColoringSample(double seconds)
+    {
+#if SEARCH_PROFILE
+        coloring_seconds += std::max(0.0, seconds - ProfileClock::Overhead()) * kColoringSample;
+#endif
+    }
+
+    void RecordIncumbent(double seconds, int size)
+    {
+#if SEARCH_PROFILE
+        incumbents.push_back({ seconds, size });
+#endif
+    }
+
+    // adds the counters of a thread or of a part of the search, the search time and the incumbents stay
+    // the ones of this profile
+    void Merge(const BnBProfile& other)
+    {
+#if SEARCH_PROFILE
+        if (other.depth_nodes.size() > depth_nodes.size())
+        {
+            depth_nodes.resize(other.depth_nodes.size(), 0);
+        }
+        for (size_t depth = 0; depth < other.depth_nodes.size(); ++depth)
+        {
+            depth_nodes[depth] += other.depth_nodes[depth];
+        }
+        coloring_prunes += other.coloring_prunes;
+        thread_seconds += other.thread_seconds;
+        coloring_seconds += other.coloring_seconds;
+#endif
+    }
+
+    // seconds to the last improvement, 0 if there was none
+    double TimeToBest() const
+    {
+        return incumbents.empty() ? 0 : incumbents.back().seconds;
+    }
+};
+
+// a run of a tabu search
+struct TabuProfile
+{
+    // vertices added by Move, successful swaps and random destructions of the clique
+    long long moves = 0;
+    long long swaps = 0;
+    long long destroys = 0;
+    double search_seconds = 0;
+    // every improvement of the best clique
+    std::vector<ProfileEvent> incumbents;
+
+    void CountMove()
+    {
+#if SEARCH_PROFILE
+        ++moves;
+#endif
+    }
+
+    void CountSwap()
+    {
+#if SEARCH_PROFILE
+        ++swaps;
+#endif
+    }
+
+    void CountDestroy()
+    {
+#if SEARCH_PROFILE
+        ++destroys;
+#endif
+    }
+
+    void RecordIncumbent(double seconds, int size)
+    {
+#if SEARCH_PROFILE
+        incumbents.push_back({ seconds, size });
+#endif
+    }
+
+    // adds the counters of another search, e.g. a worker of a portfolio
+    void Merge(const TabuProfile& other)
+    {
+#if SEARCH_PROFILE
+        moves += other.moves;
+        swaps += other.swaps;
+        destroys += other.destroys;
+#endif
+    }
+
+    // seconds to the last improvement, 0 if there was none
+    double TimeToBest() const
+    {
+        return incumbents.empty() ? 0 : incumbents.back().seconds;
+    }
+};
@@ -0,0 +1,145 @@
+#include "work_stealing_pool.h"
+
+using namespace std;
+
+namespace
+{
+    thread_local const WorkStealingPool* current_pool = nullptr;
+    thread_local int current_worker = -1;
+}
+
+WorkStealingPool::WorkStealingPool(int thread_count)
+{
+    if (thread_count < 1)
+    {
+        thread_count = 1;
+    }
+    for (int i = 0; i < thread_count; ++i)
+    {
+        workers.push_back(make_unique<Worker>());
+    }
+    for (int i = 0; i < thread_count; ++i)
+    {
+        threads.emplace_back(&WorkStealingPool::WorkerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    Wait();
+    {
+        lock_guard<mutex> lock(wake_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::Submit(function<void()> task)
+{
+    ++pending;
+    int worker = CurrentWorker();
+    if (worker >= 0)
+    {
+        lock_guard<mutex> lock(workers[worker]->mutex);
+        workers[worker]->tasks.push_back(move(task));
+    }
+    else
+    {
+        lock_guard<mutex> lock(shared_mutex);
+        shared_tasks.push_back(move(task));
+    }
+    {
+        lock_guard<mutex> lock(wake_mutex);
+        ++queued;
+    }
+    wake.notify_one();
+}
+
+void WorkStealingPool::Wait()
+{
+    unique_lock<mutex> lock(wake_mutex);
+    finished.wait(lock, [this] { return pending == 0; });
+}
+
+int WorkStealingPool::GetThreadCount() const
+{
+    return threads.size();
+}
+
+bool WorkStealingPool::NeedsTasks() const
+{
+    return queued.load(memory_order_relaxed) < (long long)threads.size();
+}
+
+int WorkStealingPool::CurrentWorker() const
+{
+    return current_pool == this ? current_worker : -1;
+}
+
+bool WorkStealingPool::TryTakeTask(int worker, function<void()>& task)
+{
+    {
+        lock_guard<mutex> lock(workers[worker]->mutex);
+        if (!workers[worker]->tasks.empty())
+        {
+            task = move(workers[worker]->tasks.back());
+            workers[worker]->tasks.pop_back();
+            --queued;
+            return true;
+        }
+    }
+    {
+        lock_guard<mutex> lock(shared_mutex);
+        if (!shared_tasks.empty())
+        {
+            task = move(shared_tasks.front());
+            shared_tasks.pop_front();
+            --queued;
+            return true;
+        }
+    }
+    for (size_t i = 1; i < workers.size(); ++i)
+    {
+        Worker& victim = *workers[(worker + i) % workers.size()];
+        lock_guard<mutex> lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --queued;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::WorkerLoop(int worker)
+{
+    current_pool = this;
+    current_worker = worker;
+    function<void()> task;
+    while (true)
+    {
+        if (TryTakeTask(worker, task))
+        {
+            task();
+            task = nullptr;
+            if (--pending == 0)
+            {
+                lock_guard<mutex> lock(wake_mutex);
+                finished.notify_all();
+            }
+            continue;
+        }
+        unique_lock<mutex> lock(wake_mutex);
+        wake.wait(lock, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0)
+        {
+            return;
+        }
+    }
+}
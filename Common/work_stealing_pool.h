@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+
+// a thread pool where every worker has its own deque of tasks: the owner takes the newest task,
+// idle workers take the oldest one from the shared queue or steal the oldest task of another worker
+class WorkStealingPool
+{
+public:
+    explicit WorkStealingPool(int thread_count);
+
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // a task submitted from a worker goes to its own deque, from other threads to the shared queue
+    void Submit(std::function<void()> task);
+
+    // blocks until every submitted task, including the ones submitted by tasks, is finished
+    void Wait();
+
+    int GetThreadCount() const;
+
+    // true when there are fewer queued tasks than threads, so splitting work further is worth it
+    bool NeedsTasks() const;
+
+    // index of the calling worker of this pool, -1 for other threads
+    int CurrentWorker() const;
+
+private:
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::mutex shared_mutex;
+    std::deque<std::function<void()>> shared_tasks;
+
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    std::atomic<long long> queued{0};
+    std::atomic<long long> pending{0};
+    std::atomic<bool> stopping{false};
+
+    bool TryTakeTask(int worker, std::function<void()>& task);
+
+    void WorkerLoop(int worker);
+};
@@ -1,262 +1,163 @@
 #include <iostream>
-#include <iterator>
 #include <fstream>
 #include <string>
 #include <vector>
 #include <sstream>
-#include <random>
 #include <algorithm>
-#include <unordered_set>
-#include <time.h>
-#include <unordered_map>
+#include <memory>
+#include <climits>
 #include <map>
-#include <set>
+
+#include "../Common/benchmark.h"
+#include "../Common/graph_handle.h"
+#include "graph_coloring.h"
 using namespace std;
 
 
-class ColoringProblemBase
+int main(int argc, char* argv[])
 {
-public:
-    // a function to parse files
-    void ReadGraphFile(string filename)
+    vector<string> default_files = { "myciel3.col", "myciel7.col", "latin_square_10.col", "school1.col", "school1_nsh.col",
+        "mulsol.i.1.col", "inithx.i.1.col", "anna.col", "huck.col", "jean.col", "miles1000.col", "miles1500.col",
+        "fpsol2.i.1.col", "le450_5a.col", "le450_15b.col", "le450_25a.col", "games120.col",
+        "queen11_11.col", "queen5_5.col" };
+    // --order random|first-degree|last-degree|dsatur (last-degree by default, DSATUR needs more colors on the school
+    // graphs), --threads t1,t2,... to run the parallel coloring with every
+    // of these thread counts too, --iterated-time sec and --iterated-passes N for the iterated greedy stage after the
+    // greedy coloring, --tabucol-time sec for the Tabucol stage after it, 0 turns a stage off,
+    // --generate n:m,n:m,... adds a G(n, m) random graph for every pair, named random-n-m, to the instances,
+    // the rest of the options are described in benchmark.h
+    BenchmarkOptions options = ParseBenchmarkOptions(argc, argv, default_files, 1000);
+    string order = options.GetString("order", "last-degree");
+    if (MakeColoringProblem(order, GraphHandle()) == nullptr)
     {
-        ifstream fin(filename);
-        string line;
-        int vertices = 0, edges = 0;
-        while (getline(fin, line))
-        {
-            if (line[0] == 'c')
-            {
-                continue;
-            }
-
-            stringstream line_input(line);
-            char command;
-            if (line[0] == 'p')
-            {
-                string type;
-                line_input >> command >> type >> vertices >> edges;
-                neighbour_sets.resize(vertices);
-                colors.resize(vertices);
-            }
-            else
-            {
-                int start, finish;
-                line_input >> command >> start >> finish;
-                // Edges in DIMACS file can be repeated, but it is not a problem for our sets
-                neighbour_sets[start - 1].insert(finish - 1);
-                neighbour_sets[finish - 1].insert(start - 1);
-            }
-        }
+        cout << "Usage: " << argv[0] << " [--order random|first-degree|last-degree|dsatur] [--<parameter> value ...]\n";
+        return 1;
     }
-    //a function to implement greedy algorithm of graph coloring 
-    void GreedyGraphColoring()
+    double iterated_time = options.GetDouble("iterated-time", 1);
+    long long iterated_passes = options.GetInt("iterated-passes", INT_MAX);
+    double tabucol_time = options.GetDouble("tabucol-time", 1);
+    vector<int> thread_counts;
+    stringstream thread_list(options.GetString("threads", ""));
+    for (string threads; getline(thread_list, threads, ',');)
     {
-        for (int vertex : VertexColoringOrder())
-        {
-            unordered_set<int> pallete;
-            for (int i = 1; i <= maxcolor; ++i)
-            {
-                pallete.insert(i);
-            }
-
-            for (int neighbour : neighbour_sets[vertex])
-            {
-                pallete.erase(colors[neighbour]);
-            }
-            
-            if (pallete.empty())
-            {
-                colors[vertex] = ++maxcolor;
-            }
-            else
-            {    
-                colors[vertex] = *pallete.begin();
-            }
-        }
+        thread_counts.push_back(max(1, atoi(threads.c_str())));
     }
-
-    // a function to check if we have uncolored vertices and adjacent vertices with the same color
-    bool Check()
+    // the generated graphs are drawn with seed 1000 whatever the seeds of the runs are, so every run colors the
+    // same graph
+    map<string, pair<int, long long>> generated;
+    stringstream generate_list(options.GetString("generate", ""));
+    for (string sizes; getline(generate_list, sizes, ',');)
     {
-        for (size_t i = 0; i < neighbour_sets.size(); ++i)
-        {
-            if (colors[i] == 0)
-            {
-                cout << "Vertex " << i + 1 << " is not colored\n";
-                return false;
-            }
-            for (int neighbour : neighbour_sets[i])
-            {
-                if (colors[neighbour] == colors[i])
-                {
-                    cout << "Neighbour vertices " << i + 1 << ", " << neighbour + 1 <<  " have the same color\n";
-                    return false;
-                }
-            }
-        }
-        return true;
+        size_t colon = sizes.find(':');
+        int vertices = atoi(sizes.substr(0, colon).c_str());
+        long long edges = colon == string::npos ? 0 : atoll(sizes.substr(colon + 1).c_str());
+        string name = "random-" + to_string(vertices) + "-" + to_string(edges);
+        generated[name] = { vertices, edges };
+        options.files.push_back(name);
     }
+    BenchmarkReport report("color", "Colors", QualityGoal::Minimize, "Time (sec)", options);
 
-    int GetNumberOfColors()
+    string header = "Instance, Load time (sec), Colors, Time (sec)";
+    for (int threads : thread_counts)
     {
-        return maxcolor;
+        header += ", Colors (" + to_string(threads) + " threads), Time (" + to_string(threads) + " threads sec), Rounds (" + to_string(threads) + " threads)";
     }
-
-    const vector<int>& GetColors()
-    {   
-        return colors;
-    }
-    // a function to print a group of vertices corresponding their color
-    string PrintColors()
+    header += ", Iterated colors, Iterated passes, Improved colors, Time to improve (sec), Color Classes\n";
+    ofstream fout("color.csv");
+    fout << header;
+    cout << header;
+    for (string file : options.files)
     {
-        unordered_map<int, set<int>> colors_to_vertices;
-        multimap<int, int, greater<int>> popularity_to_color;
-        for (int i = 0; i < colors.size(); ++i)
-        {
-            colors_to_vertices[colors[i]].insert(i);
-        }
-        for (const auto& [color, vertices] : colors_to_vertices)
+        BenchmarkTimer load_timer;
+        auto sizes = generated.find(file);
+        GraphHandle graph = sizes == generated.end() ? GraphHandle::LoadDimacs(file)
+            : GraphHandle(GenerateRandomGraph(sizes->second.first, sizes->second.second, 1000));
+        auto problem = MakeColoringProblem(order, graph);
+        double load_time = load_timer.WallSeconds();
+        if (graph.size() == 0)
         {
-            popularity_to_color.insert({ vertices.size(), color });
+            cout << "Can't read graph file " << file << "\n";
         }
-        stringstream ss;
-        ss << "\"";
-        bool first_color = true;
-        for (const auto& [p, color] : popularity_to_color)
+        // the row of an instance shows the best greedy coloring of all the runs and their median wall time,
+        // the iterated greedy starts from that coloring, Tabucol from the result of it, and the classes are
+        // those of the final coloring
+        int best_colors = 0;
+        vector<int> best_coloring;
+        for (unsigned seed : options.seeds)
         {
-            if (!first_color) 
-            {
-                ss << ", ";
-            }
-            ss << "{";
-            bool first_vertex = true;
-            for (const auto& vertice : colors_to_vertices[color])
+            for (int rep = 0; rep < options.repetitions; ++rep)
             {
-                if (!first_vertex)
+                problem->SetSeed(seed);
+                BenchmarkTimer timer;
+                problem->GreedyGraphColoring();
+                double wall_time = timer.WallSeconds();
+                double cpu_time = timer.CpuSeconds();
+                bool valid = problem->Check();
+                if (!valid)
+                {
+                    fout << "*** WARNING: incorrect coloring: ***\n";
+                    cout << "*** WARNING: incorrect coloring: ***\n";
+                }
+                report.AddRun(file, seed, wall_time, cpu_time, problem->GetNumberOfColors(), valid);
+                if (best_colors == 0 || problem->GetNumberOfColors() < best_colors)
                 {
-                    ss << ", ";
+                    best_colors = problem->GetNumberOfColors();
+                    best_coloring = problem->GetColors();
                 }
-                ss << vertice;
-                first_vertex = false;
             }
-            ss << "}";
-            first_color = false;
-        }
-        ss << "\"";
-        return ss.str();
-    }
-protected:
-    virtual vector<int> VertexColoringOrder() = 0;
-
-    vector<int> colors;
-    int maxcolor = 1;
-    vector<unordered_set<int>> neighbour_sets;
-};
-
-//a child class of ColoringProblemBase class where we implement vertex coloring in a random order
-class RandomColoringProblem : public ColoringProblemBase
-{
-protected:
-    //a function to randomize vertex coloring order 
-    virtual vector<int> VertexColoringOrder() override
-    {
-        vector<int> vertices(neighbour_sets.size());
-        for (int i = 0; i < vertices.size(); ++i)
-        {
-            vertices[i] = i;
-        }
-        static mt19937 generator(1000);
-        shuffle(vertices.begin(), vertices.end(), generator);
-        return vertices;
-    }
-};
-
-// a child class of ColoringProblemBase class that implements "small degree last with remove" algorithm
-class LastDegreeColoringProblem : public ColoringProblemBase
-{
-protected:
-    virtual vector<int> VertexColoringOrder() override
-    {
-        unordered_map<int, unordered_set<int>> graph_cut;
-        for (int i = 0; i < neighbour_sets.size(); ++i)
-        {
-            graph_cut[i] = neighbour_sets[i];
         }
+        double median_time = report.WallStatistics(file).median;
+        stringstream row;
+        row << file << "," << load_time << "," << best_colors << "," << median_time;
 
-        vector<int> vertices;
-
-        while (!graph_cut.empty())
+        // the parallel runs are compared with the serial one above: the best colors, the median wall time
+        // and the rounds of the last run
+        for (int threads : thread_counts)
         {
-            int min_degree_vertex = graph_cut.begin()->first;
-            for (const auto& [vertex, neighbours] : graph_cut)
+            int parallel_colors = 0;
+            vector<double> parallel_times;
+            for (unsigned seed : options.seeds)
             {
-                if (neighbours.size() < graph_cut[min_degree_vertex].size())
+                for (int rep = 0; rep < options.repetitions; ++rep)
                 {
-                    min_degree_vertex = vertex;
+                    problem->SetSeed(seed);
+                    BenchmarkTimer timer;
+                    problem->ParallelGraphColoring(threads);
+                    parallel_times.push_back(timer.WallSeconds());
+                    if (!problem->Check())
+                    {
+                        fout << "*** WARNING: incorrect parallel coloring: ***\n";
+                        cout << "*** WARNING: incorrect parallel coloring: ***\n";
+                    }
+                    if (parallel_colors == 0 || problem->GetNumberOfColors() < parallel_colors)
+                    {
+                        parallel_colors = problem->GetNumberOfColors();
+                    }
                 }
             }
-            vertices.push_back(min_degree_vertex);
-            for (int neighbour : graph_cut[min_degree_vertex])
-            {
-                graph_cut[neighbour].erase(min_degree_vertex);
-            }
-            graph_cut.erase(min_degree_vertex);
-        }
-
-        reverse(vertices.begin(), vertices.end());
-        return vertices;
-    } 
-};
-
-// a child class of ColoringProblem class that implements "first degree" algorithm to color vertices
-class FirstDegreeColoringProblem : public ColoringProblemBase
-{
-protected:
-    virtual vector<int> VertexColoringOrder() override
-    {
-        multimap<int, int, greater<int>> degree_to_vertex;
-        for (int i = 0; i < neighbour_sets.size(); ++i)
-        {
-            degree_to_vertex.insert({neighbour_sets[i].size(), i});
+            row << "," << parallel_colors << "," << Summarize(parallel_times).median << "," << problem->GetParallelRounds();
         }
-        vector<int> vertices;
-        for (const auto& [degree, vertex] : degree_to_vertex)
+        problem->SetSeed(options.seeds[0]);
+        problem->IteratedGreedyColoring(best_coloring, iterated_time, iterated_passes);
+        if (!problem->Check())
         {
-            vertices.push_back(vertex);
+            fout << "*** WARNING: incorrect iterated greedy coloring: ***\n";
+            cout << "*** WARNING: incorrect iterated greedy coloring: ***\n";
         }
-        return vertices;
-    }
-};
-
-
-int main()
-{
-    vector<string> files = { "myciel3.col", "myciel7.col", "latin_square_10.col", "school1.col", "school1_nsh.col",
-        "mulsol.i.1.col", "inithx.i.1.col", "anna.col", "huck.col", "jean.col", "miles1000.col", "miles1500.col",
-        "fpsol2.i.1.col", "le450_5a.col", "le450_15b.col", "le450_25a.col", "games120.col",
-        "queen11_11.col", "queen5_5.col" };
-    ofstream fout("color.csv");
-    fout << "Instance, Colors, Time (sec), Color Classes\n";
-    cout << "Instance, Colors, Time (sec), Color Classes\n";
-    for (string file : files)
-    {
-        //RandomColoringProblem problem;
-        //FirstDegreeColoringProblem problem;
-        LastDegreeColoringProblem problem;
-        problem.ReadGraphFile(file);
-        clock_t start = clock();
-        problem.GreedyGraphColoring();
-        clock_t finish = clock();
-        if (! problem.Check())
+        row << "," << problem->GetNumberOfColors() << "," << problem->GetIteratedPasses();
+        vector<int> iterated_coloring = problem->GetColors();
+        problem->TabucolColoring(iterated_coloring, tabucol_time);
+        if (!problem->Check())
         {
-            fout << "*** WARNING: incorrect coloring: ***\n";
-            cout << "*** WARNING: incorrect coloring: ***\n";
+            fout << "*** WARNING: incorrect Tabucol coloring: ***\n";
+            cout << "*** WARNING: incorrect Tabucol coloring: ***\n";
         }
-        fout << file << "," << problem.GetNumberOfColors() << "," << double(finish - start) / 1000 << "," << problem.PrintColors() << '\n';
-        cout << file << "," << problem.GetNumberOfColors() << "," << double(finish - start) / 1000 << "," << problem.PrintColors() << '\n';
-     
+        row << "," << problem->GetNumberOfColors() << "," << problem->GetTimeToImprove() << "," << problem->PrintColors() << '\n';
+        fout << row.str();
+        cout << row.str();
     }
     fout.close();
+    report.CompareWithBaseline();
+    report.WriteJson();
     return 0;
-}
\ No newline at end of file
+}
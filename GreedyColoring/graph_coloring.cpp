@@ -0,0 +1,586 @@
+#include <sstream>
+#include <algorithm>
+#include <unordered_map>
+#include <map>
+#include <set>
+#include <queue>
+#include <tuple>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <numeric>
+
+#include "graph_coloring.h"
+#include "../Common/bit_ops.h"
+#include "../Common/work_stealing_pool.h"
+
+using namespace std;
+
+ColoringProblemBase::ColoringProblemBase(const GraphHandle& graph) : graph(graph)
+{
+    colors.resize(graph.size());
+}
+
+void ColoringProblemBase::GreedyGraphColoring()
+{
+    fill(colors.begin(), colors.end(), 0);
+    maxcolor = 1;
+    // bit c is set when color c is taken by a neighbour, bit 0 stands for "uncolored" and is always set
+    vector<Word> forbidden;
+    for (int vertex : VertexColoringOrder())
+    {
+        forbidden.assign(WordsFor(maxcolor + 2), 0);
+        forbidden[0] = 1;
+        for (int neighbour : graph[vertex])
+        {
+            forbidden[colors[neighbour] / kWordBits] |= Word(1) << (colors[neighbour] % kWordBits);
+        }
+        colors[vertex] = FirstZeroBit(forbidden.data(), forbidden.size());
+        if (colors[vertex] > maxcolor)
+        {
+            maxcolor = colors[vertex];
+        }
+    }
+}
+
+void ColoringProblemBase::ParallelGraphColoring(int threads)
+{
+    threads = max(threads, 1);
+    vector<int> order = VertexColoringOrder();
+    int vertices = order.size();
+    vector<int> position(vertices);
+    int max_degree = 0;
+    for (int i = 0; i < vertices; ++i)
+    {
+        position[order[i]] = i;
+        max_degree = max<int>(max_degree, graph[i].size());
+    }
+    // the colors are read by other threads while they change, value-initialization makes them all 0
+    vector<atomic<int>> shared_colors(vertices);
+    WorkStealingPool pool(threads);
+    // a color c is taken for the vertex when taken[c] holds the stamp of the vertex, no color is above
+    // max_degree + 1, so the arrays never have to be cleared
+    vector<vector<long long>> taken(threads, vector<long long>(max_degree + 2, 0));
+    vector<long long> stamps(threads, 0);
+    vector<vector<int>> thread_conflicts(threads);
+
+    vector<int> uncolored = order;
+    parallel_rounds = 0;
+    recolored = 0;
+    while (!uncolored.empty())
+    {
+        ++parallel_rounds;
+        int tasks = threads * kBlocksPerThread;
+        int block = max<int>(kMinParallelBlock, (uncolored.size() + tasks - 1) / tasks);
+        for (int first = 0; first < uncolored.size(); first += block)
+        {
+            int last = min<int>(first + block, uncolored.size());
+            pool.Submit([&, first, last]
+                {
+                    int worker = pool.CurrentWorker();
+                    vector<long long>& worker_taken = taken[worker];
+                    for (int k = first; k < last; ++k)
+                    {
+                        int vertex = uncolored[k];
+                        long long stamp = ++stamps[worker];
+                        for (int neighbour : graph[vertex])
+                        {
+                            worker_taken[shared_colors[neighbour].load(memory_order_relaxed)] = stamp;
+                        }
+                        int color = 1;
+                        while (worker_taken[color] == stamp)
+                        {
+                            ++color;
+                        }
+                        shared_colors[vertex].store(color, memory_order_relaxed);
+                    }
+                });
+        }
+        pool.Wait();
+
+        // of two neighbours with the same color the one later in the order gives it up
+        for (int first = 0; first < uncolored.size(); first += block)
+        {
+            int last = min<int>(first + block, uncolored.size());
+            pool.Submit([&, first, last]
+                {
+                    vector<int>& conflicts = thread_conflicts[pool.CurrentWorker()];
+                    for (int k = first; k < last; ++k)
+                    {
+                        int vertex = uncolored[k];
+                        int color = shared_colors[vertex].load(memory_order_relaxed);
+                        for (int neighbour : graph[vertex])
+                        {
+                            if (shared_colors[neighbour].load(memory_order_relaxed) == color && position[neighbour] < position[vertex])
+                            {
+                                conflicts.push_back(vertex);
+                                break;
+                            }
+                        }
+                    }
+                });
+        }
+        pool.Wait();
+
+        uncolored.clear();
+        for (auto& conflicts : thread_conflicts)
+        {
+            uncolored.insert(uncolored.end(), conflicts.begin(), conflicts.end());
+            conflicts.clear();
+        }
+        sort(uncolored.begin(), uncolored.end(), [&](int a, int b) { return position[a] < position[b]; });
+        recolored += uncolored.size();
+    }
+
+    maxcolor = 1;
+    for (int i = 0; i < vertices; ++i)
+    {
+        colors[i] = shared_colors[i].load(memory_order_relaxed);
+        maxcolor = max(maxcolor, colors[i]);
+    }
+}
+
+void ColoringProblemBase::IteratedGreedyColoring(const vector<int>& initial, double time_limit, long long max_passes)
+{
+    auto deadline = chrono::steady_clock::now()
+        + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(time_limit));
+    int vertices = initial.size();
+    colors.assign(initial.begin(), initial.end());
+    maxcolor = vertices ? *max_element(colors.begin(), colors.end()) : 1;
+    pass_order.resize(vertices);
+    iota(pass_order.begin(), pass_order.end(), 0);
+    class_vertices.resize(vertices);
+    // no color is above the first maxcolor, see above
+    taken.assign(maxcolor + 2, 0);
+    long long stamp = 0;
+    iterated_passes = 0;
+    while (iterated_passes < max_passes && chrono::steady_clock::now() < deadline)
+    {
+        ++iterated_passes;
+        // class c is class_vertices[class_start[c]] ... class_vertices[class_start[c + 1] - 1]
+        class_start.assign(maxcolor + 2, 0);
+        for (int v = 0; v < vertices; ++v)
+        {
+            ++class_start[colors[v] + 1];
+        }
+        for (int c = 1; c <= maxcolor; ++c)
+        {
+            class_start[c + 1] += class_start[c];
+        }
+        class_fill.assign(class_start.begin(), class_start.end());
+        for (int v : pass_order)
+        {
+            class_vertices[class_fill[colors[v]]++] = v;
+        }
+
+        class_sequence.resize(maxcolor);
+        iota(class_sequence.begin(), class_sequence.end(), 1);
+        switch (uniform_int_distribution<int>(0, 2)(generator))
+        {
+        case 0:
+            reverse(class_sequence.begin(), class_sequence.end());
+            break;
+        case 1:
+            sort(class_sequence.begin(), class_sequence.end(), [&](int a, int b)
+                {
+                    int size_a = class_start[a + 1] - class_start[a];
+                    int size_b = class_start[b + 1] - class_start[b];
+                    return size_a != size_b ? size_a > size_b : a < b;
+                });
+            break;
+        default:
+            shuffle(class_sequence.begin(), class_sequence.end(), generator);
+            break;
+        }
+        int next = 0;
+        for (int c : class_sequence)
+        {
+            for (int i = class_start[c]; i < class_start[c + 1]; ++i)
+            {
+                pass_order[next++] = class_vertices[i];
+            }
+        }
+
+        fill(colors.begin(), colors.end(), 0);
+        int pass_colors = 1;
+        for (int vertex : pass_order)
+        {
+            ++stamp;
+            for (int neighbour : graph[vertex])
+            {
+                taken[colors[neighbour]] = stamp;
+            }
+            int color = 1;
+            while (taken[color] == stamp)
+            {
+                ++color;
+            }
+            colors[vertex] = color;
+            pass_colors = max(pass_colors, color);
+        }
+        maxcolor = pass_colors;
+    }
+}
+
+long long ColoringProblemBase::GetIteratedPasses()
+{
+    return iterated_passes;
+}
+
+void ColoringProblemBase::TabucolColoring(const vector<int>& initial, double time_limit)
+{
+    auto start = chrono::steady_clock::now();
+    auto deadline = start + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(time_limit));
+    int vertices = initial.size();
+    colors = initial;
+    maxcolor = vertices ? *max_element(colors.begin(), colors.end()) : 1;
+    vector<int> best_colors = colors;
+    time_to_improve = 0;
+    tabucol_iterations = 0;
+    conflict_position.assign(vertices, -1);
+
+    while (maxcolor > 1 && chrono::steady_clock::now() < deadline)
+    {
+        int k = maxcolor - 1;
+        gamma.assign((size_t)vertices * k, 0);
+        tabu_until.assign((size_t)vertices * k, 0);
+        for (int v = 0; v < vertices; ++v)
+        {
+            if (colors[v] <= k)
+            {
+                for (int neighbour : graph[v])
+                {
+                    ++gamma[(size_t)neighbour * k + colors[v] - 1];
+                }
+            }
+        }
+        for (int v = 0; v < vertices; ++v)
+        {
+            if (colors[v] > k)
+            {
+                const int* row = &gamma[(size_t)v * k];
+                int color = min_element(row, row + k) - row;
+                colors[v] = color + 1;
+                for (int neighbour : graph[v])
+                {
+                    ++gamma[(size_t)neighbour * k + color];
+                }
+            }
+        }
+        conflicting.clear();
+        long long conflicts = 0;
+        for (int v = 0; v < vertices; ++v)
+        {
+            conflict_position[v] = -1;
+            UpdateConflicting(v, k);
+            conflicts += gamma[(size_t)v * k + colors[v] - 1];
+        }
+        conflicts /= 2;
+        long long best_conflicts = conflicts;
+
+        while (conflicts > 0)
+        {
+            // the clock is read once per this many iterations
+            if ((++tabucol_iterations & 1023) == 0 && chrono::steady_clock::now() >= deadline)
+            {
+                break;
+            }
+            // the best move of a conflicting vertex, a tabu one only if it gives the fewest conflicts so far.
+            // Ties are broken at random
+            int best_delta = INT_MAX;
+            int move_vertex = -1;
+            int move_color = 0;
+            int ties = 0;
+            for (int vertex : conflicting)
+            {
+                const int* row = &gamma[(size_t)vertex * k];
+                const long long* tabu = &tabu_until[(size_t)vertex * k];
+                int old_color = colors[vertex] - 1;
+                for (int color = 0; color < k; ++color)
+                {
+                    int delta = row[color] - row[old_color];
+                    if (color == old_color || delta > best_delta
+                        || (tabu[color] > tabucol_iterations && conflicts + delta >= best_conflicts))
+                    {
+                        continue;
+                    }
+                    if (delta < best_delta)
+                    {
+                        best_delta = delta;
+                        ties = 0;
+                    }
+                    if (uniform_int_distribution<int>(0, ties++)(generator) == 0)
+                    {
+                        move_vertex = vertex;
+                        move_color = color;
+                    }
+                }
+            }
+            if (move_vertex < 0)
+            {
+                continue;
+            }
+
+            int old_color = colors[move_vertex] - 1;
+            colors[move_vertex] = move_color + 1;
+            conflicts += best_delta;
+            for (int neighbour : graph[move_vertex])
+            {
+                --gamma[(size_t)neighbour * k + old_color];
+                ++gamma[(size_t)neighbour * k + move_color];
+                UpdateConflicting(neighbour, k);
+            }
+            UpdateConflicting(move_vertex, k);
+            tabu_until[(size_t)move_vertex * k + old_color] = tabucol_iterations + (long long)(0.6 * conflicts)
+                + uniform_int_distribution<int>(0, 9)(generator);
+            best_conflicts = min(best_conflicts, conflicts);
+        }
+        if (conflicts > 0)
+        {
+            break;
+        }
+        maxcolor = k;
+        best_colors = colors;
+        time_to_improve = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+    colors = best_colors;
+    maxcolor = vertices ? *max_element(colors.begin(), colors.end()) : 1;
+}
+
+double ColoringProblemBase::GetTimeToImprove()
+{
+    return time_to_improve;
+}
+
+long long ColoringProblemBase::GetTabucolIterations()
+{
+    return tabucol_iterations;
+}
+
+int ColoringProblemBase::GetParallelRounds()
+{
+    return parallel_rounds;
+}
+
+long long ColoringProblemBase::GetRecolored()
+{
+    return recolored;
+}
+
+bool ColoringProblemBase::Check()
+{
+    for (int i = 0; i < graph.size(); ++i)
+    {
+        if (colors[i] == 0)
+        {
+            return false;
+        }
+        for (int neighbour : graph[i])
+        {
+            if (colors[neighbour] == colors[i])
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void ColoringProblemBase::SetSeed(unsigned seed)
+{
+    generator.seed(seed);
+}
+
+const vector<int>& ColoringProblemBase::GetColors()
+{
+    return colors;
+}
+
+int ColoringProblemBase::GetNumberOfColors()
+{
+    return maxcolor;
+}
+
+string ColoringProblemBase::PrintColors()
+{
+    unordered_map<int, set<int>> colors_to_vertices;
+    multimap<int, int, greater<int>> popularity_to_color;
+    for (int i = 0; i < colors.size(); ++i)
+    {
+        colors_to_vertices[colors[i]].insert(i);
+    }
+    for (const auto& [color, vertices] : colors_to_vertices)
+    {
+        popularity_to_color.insert({ vertices.size(), color });
+    }
+    stringstream ss;
+    ss << "\"";
+    bool first_color = true;
+    for (const auto& [p, color] : popularity_to_color)
+    {
+        if (!first_color) 
+        {
+            ss << ", ";
+        }
+        ss << "{";
+        bool first_vertex = true;
+        for (const auto& vertice : colors_to_vertices[color])
+        {
+            if (!first_vertex)
+            {
+                ss << ", ";
+            }
+            ss << vertice;
+            first_vertex = false;
+        }
+        ss << "}";
+        first_color = false;
+    }
+    ss << "\"";
+    return ss.str();
+}
+
+void ColoringProblemBase::UpdateConflicting(int vertex, int k)
+{
+    bool conflict = gamma[(size_t)vertex * k + colors[vertex] - 1] > 0;
+    if (conflict && conflict_position[vertex] < 0)
+    {
+        conflict_position[vertex] = conflicting.size();
+        conflicting.push_back(vertex);
+    }
+    else if (!conflict && conflict_position[vertex] >= 0)
+    {
+        int last = conflicting.back();
+        conflicting[conflict_position[vertex]] = last;
+        conflict_position[last] = conflict_position[vertex];
+        conflicting.pop_back();
+        conflict_position[vertex] = -1;
+    }
+}
+
+vector<int> RandomColoringProblem::VertexColoringOrder()
+{
+    vector<int> vertices(graph.size());
+    for (int i = 0; i < vertices.size(); ++i)
+    {
+        vertices[i] = i;
+    }
+    shuffle(vertices.begin(), vertices.end(), generator);
+    return vertices;
+}
+
+vector<int> LastDegreeColoringProblem::VertexColoringOrder()
+{
+    vector<int> vertices = graph.Degeneracy().order;
+    reverse(vertices.begin(), vertices.end());
+    return vertices;
+}
+
+vector<int> FirstDegreeColoringProblem::VertexColoringOrder()
+{
+    multimap<int, int, greater<int>> degree_to_vertex;
+    for (int i = 0; i < graph.size(); ++i)
+    {
+        degree_to_vertex.insert({graph[i].size(), i});
+    }
+    vector<int> vertices;
+    for (const auto& [degree, vertex] : degree_to_vertex)
+    {
+        vertices.push_back(vertex);
+    }
+    return vertices;
+}
+
+vector<int> DsaturColoringProblem::VertexColoringOrder()
+{
+    int vertices = graph.size();
+    // a vertex never needs a color above its degree + 1, so row v has WordsFor(degree + 2) words and bit c set
+    // when a neighbour of v has color c, bit 0 is always set. The rows take O(V + E / 64) words even with a hub.
+    // Neighbour colors above the row only count for the saturation, they are listed in high_colors
+    vector<size_t> row_offsets(vertices + 1, 0);
+    for (int v = 0; v < vertices; ++v)
+    {
+        row_offsets[v + 1] = row_offsets[v] + WordsFor(graph[v].size() + 2);
+    }
+    vector<Word> neighbour_colors(row_offsets[vertices], 0);
+    vector<vector<int>> high_colors(vertices);
+    vector<int> saturation(vertices, 0);
+    vector<int> uncolored_degree(vertices);
+    vector<bool> colored(vertices, false);
+
+    // entries are (saturation, uncolored degree, -vertex), an entry is stale if the vertex changed since
+    priority_queue<tuple<int, int, int>> queue;
+    for (int v = 0; v < vertices; ++v)
+    {
+        neighbour_colors[row_offsets[v]] = 1;
+        uncolored_degree[v] = graph[v].size();
+        queue.push({ 0, uncolored_degree[v], -v });
+    }
+
+    vector<int> order;
+    order.reserve(vertices);
+    while (!queue.empty())
+    {
+        auto [vertex_saturation, degree, negative_vertex] = queue.top();
+        queue.pop();
+        int vertex = -negative_vertex;
+        if (colored[vertex] || vertex_saturation != saturation[vertex] || degree != uncolored_degree[vertex])
+        {
+            continue;
+        }
+        colored[vertex] = true;
+        order.push_back(vertex);
+        int color = FirstZeroBit(&neighbour_colors[row_offsets[vertex]], row_offsets[vertex + 1] - row_offsets[vertex]);
+        Word color_bit = Word(1) << (color % kWordBits);
+        for (int neighbour : graph[vertex])
+        {
+            if (colored[neighbour])
+            {
+                continue;
+            }
+            --uncolored_degree[neighbour];
+            size_t position = row_offsets[neighbour] + color / kWordBits;
+            if (position < row_offsets[neighbour + 1])
+            {
+                Word& word = neighbour_colors[position];
+                if ((word & color_bit) == 0)
+                {
+                    word |= color_bit;
+                    ++saturation[neighbour];
+                }
+            }
+            else
+            {
+                vector<int>& high = high_colors[neighbour];
+                if (find(high.begin(), high.end(), color) == high.end())
+                {
+                    high.push_back(color);
+                    ++saturation[neighbour];
+                }
+            }
+            queue.push({ saturation[neighbour], uncolored_degree[neighbour], -neighbour });
+        }
+    }
+    return order;
+}
+
+unique_ptr<ColoringProblemBase> MakeColoringProblem(const string& order, const GraphHandle& graph)
+{
+    if (order == "random")
+    {
+        return make_unique<RandomColoringProblem>(graph);
+    }
+    if (order == "first-degree")
+    {
+        return make_unique<FirstDegreeColoringProblem>(graph);
+    }
+    if (order == "last-degree")
+    {
+        return make_unique<LastDegreeColoringProblem>(graph);
+    }
+    if (order == "dsatur")
+    {
+        return make_unique<DsaturColoringProblem>(graph);
+    }
+    return nullptr;
+}
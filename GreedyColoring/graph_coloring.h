@@ -0,0 +1,150 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <random>
+#include <memory>
+
+#include "../Common/graph_handle.h"
+
+// greedy graph coloring in the vertex order of a child class, with a parallel version and the iterated greedy and
+// Tabucol stages that try to use fewer colors afterwards
+class ColoringProblemBase
+{
+public:
+    explicit ColoringProblemBase(const GraphHandle& graph);
+
+    virtual ~ColoringProblemBase() = default;
+
+    //a function to implement greedy algorithm of graph coloring, every vertex gets the smallest color
+    // that none of its neighbours has
+    void GreedyGraphColoring();
+
+    // a function to implement the speculative parallel greedy coloring of Gebremedhin and Manne. Blocks of the
+    // coloring order are tasks of a work-stealing pool, every vertex gets the smallest color that none of its
+    // neighbours had when it looked at them. Then the vertices that share a color with a neighbour earlier in the
+    // order are collected and colored again in the next round, until no conflicts are left. On one thread this is
+    // the greedy coloring in the same order
+    void ParallelGraphColoring(int threads);
+
+    // a function to implement the iterated greedy coloring of Culberson. Every pass colors the vertices again
+    // class by class, taking the classes of the last coloring reversed, largest first or in random order, and
+    // inside a class in the order of the last pass. A greedy pass in such an order never needs more colors than
+    // the last one, so the number of colors can only go down. Runs until the time or the passes run out,
+    // the buffers are sized by the first pass and reused by the rest
+    void IteratedGreedyColoring(const std::vector<int>& initial, double time_limit, long long max_passes);
+
+    long long GetIteratedPasses();
+
+    // a function to implement Tabucol (Hertz and de Werra, with the tenure of Galinier and Hao) after the greedy
+    // coloring. Starting from the given coloring with k colors, the vertices of color k take the color below it
+    // with the fewest neighbours, then single vertices move to other colors until no two neighbours share one.
+    // Then the same goes on with one color less, until the time runs out. gamma[v * k + c] is the number of
+    // neighbours of v with color c + 1, so every move is evaluated in O(1), and a move back to the old color is
+    // tabu until the iteration stored for it. The coloring is the best proper one found
+    void TabucolColoring(const std::vector<int>& initial, double time_limit);
+
+    // seconds from the start of the last Tabucol run to its last improvement, 0 if it found none
+    double GetTimeToImprove();
+
+    long long GetTabucolIterations();
+
+    // rounds of the last parallel coloring, 1 when no vertex had to be colored again
+    int GetParallelRounds();
+
+    // vertices the last parallel coloring colored again because of conflicts
+    long long GetRecolored();
+
+    // a function to check if we have uncolored vertices and adjacent vertices with the same color
+    bool Check();
+
+    // the seed of the orders that use random numbers
+    void SetSeed(unsigned seed);
+
+    int GetNumberOfColors();
+
+    const std::vector<int>& GetColors();
+    // a function to print a group of vertices corresponding their color
+    std::string PrintColors();
+
+protected:
+    virtual std::vector<int> VertexColoringOrder() = 0;
+
+    // keeps the vertex in the conflicting list of Tabucol exactly when a neighbour has its color
+    void UpdateConflicting(int vertex, int k);
+
+    // a round of the parallel coloring is split into this many tasks per thread, so the threads can steal from each
+    // other, but a task gets at least kMinParallelBlock vertices of the order
+    static const int kBlocksPerThread = 4;
+    static const int kMinParallelBlock = 32;
+
+    std::vector<int> colors;
+    int maxcolor = 1;
+    GraphHandle graph;
+    int parallel_rounds = 0;
+    long long recolored = 0;
+    // Tabucol state: the conflict table, the iteration until which a vertex can't go back to a color,
+    // the vertices that share a color with a neighbour and the place of every vertex in that list
+    std::vector<int> gamma;
+    std::vector<long long> tabu_until;
+    std::vector<int> conflicting;
+    std::vector<int> conflict_position;
+    double time_to_improve = 0;
+    long long tabucol_iterations = 0;
+    // iterated greedy buffers: the order of the last pass, its vertices grouped by color, where every class starts
+    // and is filled, the order of the classes, and the stamps of the colors taken by the neighbours of a vertex
+    std::vector<int> pass_order;
+    std::vector<int> class_vertices;
+    std::vector<int> class_start;
+    std::vector<int> class_fill;
+    std::vector<int> class_sequence;
+    std::vector<long long> taken;
+    long long iterated_passes = 0;
+    std::mt19937 generator{ 1000 };
+};
+
+//a child class of ColoringProblemBase class where we implement vertex coloring in a random order
+class RandomColoringProblem : public ColoringProblemBase
+{
+public:
+    using ColoringProblemBase::ColoringProblemBase;
+
+protected:
+    //a function to randomize vertex coloring order 
+    virtual std::vector<int> VertexColoringOrder() override;
+};
+
+// a child class of ColoringProblemBase class that implements "small degree last with remove" algorithm
+class LastDegreeColoringProblem : public ColoringProblemBase
+{
+public:
+    using ColoringProblemBase::ColoringProblemBase;
+
+protected:
+    virtual std::vector<int> VertexColoringOrder() override;
+};
+
+// a child class of ColoringProblem class that implements "first degree" algorithm to color vertices
+class FirstDegreeColoringProblem : public ColoringProblemBase
+{
+public:
+    using ColoringProblemBase::ColoringProblemBase;
+
+protected:
+    virtual std::vector<int> VertexColoringOrder() override;
+};
+
+// a child class of ColoringProblemBase class that implements DSATUR: the next vertex is the one with the most
+// distinct colors among its neighbours, ties go to the largest degree among the uncolored vertices.
+// The order is found by coloring the graph, the greedy coloring in this order then gives the same colors
+class DsaturColoringProblem : public ColoringProblemBase
+{
+public:
+    using ColoringProblemBase::ColoringProblemBase;
+
+protected:
+    virtual std::vector<int> VertexColoringOrder() override;
+};
+
+// a function to create the coloring problem with the given order: random, first-degree, last-degree or dsatur,
+// returns nullptr for any other name
+std::unique_ptr<ColoringProblemBase> MakeColoringProblem(const std::string& order, const GraphHandle& graph);
@@ -0,0 +1,133 @@
+#include <sstream>
+#include <algorithm>
+
+#include "max_clique_problem.h"
+#include "../Common/counter_random.h"
+#include "../Common/work_stealing_pool.h"
+
+using namespace std;
+
+MaxCliqueProblem::MaxCliqueProblem(const GraphHandle& graph) : graph(graph)
+{
+    vector<int> ldwr_order = graph.Degeneracy().order;
+    reverse(ldwr_order.begin(), ldwr_order.end());
+    candidates.Init(graph, ldwr_order);
+}
+
+void MaxCliqueProblem::SetSeed(unsigned new_seed)
+{
+    seed = new_seed;
+}
+
+void MaxCliqueProblem::FindClique(int iterations, int threads)
+{
+    threads = max(threads, 1);
+    vector<IterationsBest> thread_best(threads);
+    if (threads == 1)
+    {
+        RunIterations(0, iterations, iterations, candidates, thread_best[0]);
+    }
+    else
+    {
+        // every thread changes the candidate bits of its own copy
+        vector<OrderedCandidates> thread_candidates(threads, candidates);
+        WorkStealingPool pool(threads);
+        for (int first = 0; first < iterations; first += kIterationBlock)
+        {
+            int last = min(first + kIterationBlock, iterations);
+            pool.Submit([&, first, last]
+                {
+                    int worker = pool.CurrentWorker();
+                    RunIterations(first, last, iterations, thread_candidates[worker], thread_best[worker]);
+                });
+        }
+        pool.Wait();
+    }
+
+    IterationsBest best;
+    for (auto& result : thread_best)
+    {
+        if (result.IsBetter(best))
+        {
+            best = move(result);
+        }
+    }
+    best_clique = best.clique;
+    best_randomization = best.iteration >= 0 ? (float)best.iteration / iterations : 0;
+}
+
+float MaxCliqueProblem::GetBestRandomization()
+{
+    return best_randomization;
+}
+
+string MaxCliqueProblem::PrintClique()
+{
+    vector<int> best_clique = GetClique();
+    sort(best_clique.begin(), best_clique.end());
+    stringstream ss;
+    ss << "\"";
+    bool first_vertex = true;
+    ss << "{";
+    for (const auto& vertex : best_clique)
+    {
+        if (!first_vertex)
+        {
+            ss << ",";
+        }
+        ss << vertex;
+        first_vertex = false;
+    }
+    ss << "}";
+    ss << "\"";
+    return ss.str();
+}
+
+const vector<int>& MaxCliqueProblem::GetClique()
+{
+    return best_clique;
+}
+
+bool MaxCliqueProblem::Check()
+{
+    if (unique(best_clique.begin(), best_clique.end()) != best_clique.end())
+    {
+        return false;
+    }
+    for (int i : best_clique)
+    {
+        for (int j : best_clique)
+        {
+            if (i != j && !graph.IsAdjacent(i, j))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void MaxCliqueProblem::RunIterations(int first, int last, int iterations, OrderedCandidates& candidates, IterationsBest& best)
+{
+    IterationsBest current;
+    for (int iteration = first; iteration < last; ++iteration)
+    {
+        // here we'd like to check different randomizations
+        float randomization = (float)iteration / iterations;
+        CounterRandom random(seed, iteration);
+
+        current.clique.clear();
+        current.iteration = iteration;
+        candidates.Reset();
+        while (!candidates.Empty())
+        {
+            uniform_int_distribution<int> uniform(0, min<int>(randomization * candidates.Size() + (iteration ? 1 : 0), candidates.Size() - 1));
+            current.clique.push_back(candidates.Take(uniform(random)));
+        }
+        if (current.IsBetter(best))
+        {
+            best.clique = current.clique;
+            best.iteration = iteration;
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <random>
+
+#include "../Common/graph_handle.h"
+#include "../Common/ordered_candidates.h"
+
+// randomized greedy search for a large clique: every iteration builds a clique from the candidates in last degree
+// with remove order, taking one of the first ones at random, and later iterations pick from more of them
+class MaxCliqueProblem
+{
+public:
+    // the candidate rows of the greedy construction are built here once, every FindClique starts from them
+    explicit MaxCliqueProblem(const GraphHandle& graph);
+
+    void SetSeed(unsigned new_seed);
+
+    // a function to find the best clique among all the iterations along with the best randomization
+    // iterations are spread over the threads in blocks, every iteration draws from its own random stream
+    // keyed by (seed, iteration), so the result doesn't depend on the number of threads
+    void FindClique(int iterations, int threads = 1);
+
+    // the iteration that found the best clique as a share of all the iterations, later iterations pick from more
+    // of the candidates
+    float GetBestRandomization();
+
+    std::string PrintClique();
+
+    const std::vector<int>& GetClique();
+
+    bool Check();
+
+private:
+    // the best clique of some iterations, among cliques of the same size the one of the earliest iteration
+    struct IterationsBest
+    {
+        std::vector<int> clique;
+        int iteration = -1;
+
+        bool IsBetter(const IterationsBest& other) const
+        {
+            return clique.size() > other.clique.size() || (clique.size() == other.clique.size() && iteration >= 0 && iteration < other.iteration);
+        }
+    };
+
+    // iterations are handed to the threads in blocks of this size
+    static const int kIterationBlock = 64;
+
+    GraphHandle graph;
+    // candidates in last degree with remove order, the single-thread runs work on it and the threads on copies
+    OrderedCandidates candidates;
+    std::vector<int> best_clique;
+    float best_randomization = 0;
+    unsigned seed = std::mt19937::default_seed;
+
+    // a function to build a clique greedily for each of the iterations first..last-1 and to keep the best one
+    void RunIterations(int first, int last, int iterations, OrderedCandidates& candidates, IterationsBest& best);
+};
@@ -0,0 +1,461 @@
+#include <sstream>
+#include <algorithm>
+#include <thread>
+#include <cmath>
+
+#include "tabu_max_clique.h"
+
+using namespace std;
+
+void TabuPortfolio::Publish(const unordered_set<int>& clique)
+{
+    lock_guard<mutex> lock(best_mutex);
+    if (clique.size() <= best_clique.size())
+    {
+        return;
+    }
+    best_clique = clique;
+    incumbents.push_back({ chrono::duration<double>(chrono::steady_clock::now() - start).count(), (int)best_clique.size() });
+    if (target_size > 0 && best_clique.size() >= target_size && time_to_target < 0)
+    {
+        time_to_target = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        stop = true;
+    }
+}
+
+bool TabuPortfolio::ShouldStop()
+{
+    if (!stop.load(memory_order_relaxed) && chrono::steady_clock::now() > deadline)
+    {
+        stop = true;
+    }
+    return stop.load(memory_order_relaxed);
+}
+
+MaxCliqueTabuSearch::MaxCliqueTabuSearch(const GraphHandle& graph)
+    : graph(graph), non_neighbours(graph.NonNeighbours()), words(graph.Words()), adjacency(graph.AdjacencyRows())
+{
+    int vertices = graph.size();
+    qco.resize(vertices);
+    index.resize(vertices, -1);
+    tightness.resize(vertices);
+    missing_sum.resize(vertices);
+    one_tight.resize(vertices);
+    one_tight_position.resize(vertices);
+    adjacent_pairs.resize(vertices);
+    tabu_insert_stamp.assign(vertices, 0);
+    tabu_remove_stamp.assign(vertices, 0);
+    one_tight_bits.assign((size_t)vertices * words, 0);
+    vector<int> ldwr_order = graph.Degeneracy().order;
+    reverse(ldwr_order.begin(), ldwr_order.end());
+    initial_candidates.Init(graph, ldwr_order);
+}
+
+int MaxCliqueTabuSearch::GetRandom(int a, int b)
+{
+    uniform_int_distribution<int> uniform(a, b);
+    return uniform(generator);
+}
+
+void MaxCliqueTabuSearch::SetSeed(unsigned new_seed)
+{
+    seed = new_seed;
+    generator.seed(seed);
+}
+
+void MaxCliqueTabuSearch::RunSearch(int iterations)
+{
+    best_clique.clear();
+    profile = TabuProfile();
+    run_clock.Start();
+    for (int iter = 0; iter < iterations; ++iter)
+    {
+        if (portfolio != nullptr && portfolio->ShouldStop())
+        {
+            profile.search_seconds = run_clock.Seconds();
+            return;
+        }
+        ClearClique();
+        float randomization = (float)iter / iterations;
+        randomization = sqrt(randomization);
+        FindInitialClique(randomization);
+
+        tabu_insert_maxsize = 3 + ((iter + tenure_shift) % 5);
+        tabu_remove_maxsize = 3 + tabu_insert_maxsize;
+        ClearTabu();
+        
+        //let's declare a counter of swaps and destroys 
+        int swaps = 0;
+        int destroys = 0;
+        while (destroys < 2)
+        {
+            if (q_border > best_clique.size())
+            {
+                best_clique.clear();
+                for (int i = 0; i < q_border; ++i)
+                    best_clique.insert(qco[i]);
+                profile.RecordIncumbent(run_clock.Seconds(), q_border);
+                if (portfolio != nullptr)
+                {
+                    portfolio->Publish(best_clique);
+                }
+            }
+            // a single descent can run long on big graphs, so the deadline is also checked in here
+            ++steps;
+            if (portfolio != nullptr && ((steps & (kDeadlineCheckSteps - 1)) == 0
+                ? portfolio->ShouldStop() : portfolio->stop.load(memory_order_relaxed)))
+            {
+                profile.search_seconds = run_clock.Seconds();
+                return;
+            }
+
+            if (Move())
+            {
+                profile.CountMove();
+                continue;
+            }
+            int swap_result = Swap();
+            if (swap_result > 0)
+            {
+                profile.CountSwap();
+            }
+            if (swap_result == 2)
+            {
+                continue;
+            }
+            else if (swap_result == 1 && swaps < 100)
+            {
+                ++swaps;
+            }
+            else
+            {
+                for (int i = GetRandom(2, 5); i > 0; --i)
+                {
+                    if (q_border > 0)
+                    {
+                        RemoveFromClique(qco[GetRandom(0, q_border - 1)]);
+                    }
+                }
+                ++destroys;
+                ++iter;
+                swaps = 0;
+                ClearTabu();
+                profile.CountDestroy();
+            }
+        }
+    }
+    profile.search_seconds = run_clock.Seconds();
+}
+
+double MaxCliqueTabuSearch::RunPortfolio(int threads, int iterations, int target_size, double time_limit)
+{
+    TabuPortfolio shared;
+    shared.target_size = target_size;
+    shared.start = chrono::steady_clock::now();
+    shared.deadline = shared.start + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(time_limit));
+
+    vector<MaxCliqueTabuSearch> workers(threads, *this);
+    vector<thread> pool;
+    for (int w = 0; w < threads; ++w)
+    {
+        workers[w].SetSeed(seed + w);
+        workers[w].tenure_shift = w;
+        workers[w].portfolio = &shared;
+        pool.emplace_back([&workers, w, iterations] { workers[w].RunSearch(iterations); });
+    }
+    for (auto& worker : pool)
+    {
+        worker.join();
+    }
+    best_clique = shared.best_clique;
+    profile = TabuProfile();
+    for (const auto& worker : workers)
+    {
+        profile.Merge(worker.profile);
+    }
+    profile.search_seconds = chrono::duration<double>(chrono::steady_clock::now() - shared.start).count();
+    profile.incumbents = shared.incumbents;
+    return shared.time_to_target;
+}
+
+const unordered_set<int>& MaxCliqueTabuSearch::GetClique()
+{
+    return best_clique;
+}
+
+const TabuProfile& MaxCliqueTabuSearch::GetProfile()
+{
+    return profile;
+}
+
+bool MaxCliqueTabuSearch::Check()
+{
+    for (int i : best_clique)
+    {
+        for (int j : best_clique)
+        {
+            if (i != j && !graph.IsAdjacent(i, j))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+string MaxCliqueTabuSearch::PrintClique()
+{
+    vector<int> clique;
+    clique.insert(clique.end(), best_clique.begin(), best_clique.end());
+    sort(clique.begin(), clique.end());
+    stringstream ss;
+    ss << "\"";
+    bool first_vertex = true;
+    ss << "{";
+    for (const auto& vertex : clique)
+    {
+        if (!first_vertex)
+        {
+            ss << ",";
+        }
+        ss << vertex;
+        first_vertex = false;
+    }
+    ss << "}";
+    ss << "\"";
+    return ss.str();
+}
+
+void MaxCliqueTabuSearch::ClearClique()
+{
+    q_border = 0;
+    c_border = graph.size();
+    for (int i = 0; i < graph.size(); ++i)
+    {
+        qco[i] = i;
+        index[i] = i;
+        tightness[i] = 0;
+        missing_sum[i] = 0;
+        one_tight[i].clear();
+        adjacent_pairs[i] = 0;
+    }
+    fill(one_tight_bits.begin(), one_tight_bits.end(), 0);
+}
+
+void MaxCliqueTabuSearch::ClearTabu()
+{
+    // moving the counters past the tenure expires every stamp at once
+    tabu_insert_count += tabu_insert_maxsize;
+    tabu_remove_count += tabu_remove_maxsize;
+}
+
+bool MaxCliqueTabuSearch::IsTabuToInsert(int vertex)
+{
+    return tabu_insert_count - tabu_insert_stamp[vertex] < tabu_insert_maxsize;
+}
+
+bool MaxCliqueTabuSearch::IsTabuToRemove(int vertex)
+{
+    return tabu_remove_count - tabu_remove_stamp[vertex] < tabu_remove_maxsize;
+}
+
+void MaxCliqueTabuSearch::SwapVertices(int vertex, int border)
+{
+    int vertex_at_border = qco[border];
+    swap(qco[index[vertex]], qco[border]);
+    swap(index[vertex], index[vertex_at_border]);
+}
+
+void MaxCliqueTabuSearch::InsertToClique(int i)
+{
+    for (int j : non_neighbours[i])
+    {
+        if (tightness[j] == 0)
+        {
+            --c_border;
+            SwapVertices(j, c_border);
+            AddOneTight(j, i);
+        }
+        else if (tightness[j] == 1)
+        {
+            RemoveOneTight(j, missing_sum[j]);
+        }
+        ++tightness[j];
+        missing_sum[j] += i;
+    }
+    SwapVertices(i, q_border);
+    ++q_border;
+}
+
+void MaxCliqueTabuSearch::RemoveFromClique(int k)
+{
+    // every 1-tight vertex of k becomes free, so its list goes away at once
+    for (int j : one_tight[k])
+    {
+        one_tight_bits[(size_t)k * words + j / kWordBits] = 0;
+    }
+    one_tight[k].clear();
+    adjacent_pairs[k] = 0;
+    for (int j : non_neighbours[k])
+    {
+        if (tightness[j] == 1)
+        {
+            SwapVertices(j, c_border);
+            c_border++;
+        }
+        --tightness[j];
+        missing_sum[j] -= k;
+        if (tightness[j] == 1)
+        {
+            AddOneTight(j, missing_sum[j]);
+        }
+    }
+    --q_border;
+    SwapVertices(k, q_border);
+}
+
+void MaxCliqueTabuSearch::AddOneTight(int vertex, int owner)
+{
+    adjacent_pairs[owner] += NeighboursInList(vertex, owner);
+    one_tight_bits[(size_t)owner * words + vertex / kWordBits] |= Word(1) << (vertex % kWordBits);
+    one_tight_position[vertex] = one_tight[owner].size();
+    one_tight[owner].push_back(vertex);
+}
+
+void MaxCliqueTabuSearch::RemoveOneTight(int vertex, int owner)
+{
+    one_tight_bits[(size_t)owner * words + vertex / kWordBits] &= ~(Word(1) << (vertex % kWordBits));
+    adjacent_pairs[owner] -= NeighboursInList(vertex, owner);
+    vector<int>& list = one_tight[owner];
+    int last = list.back();
+    list[one_tight_position[vertex]] = last;
+    one_tight_position[last] = one_tight_position[vertex];
+    list.pop_back();
+}
+
+int MaxCliqueTabuSearch::NeighboursInList(int vertex, int owner)
+{
+    if (one_tight[owner].empty())
+    {
+        return 0;
+    }
+    const Word* row = &adjacency[(size_t)vertex * words];
+    const Word* list = &one_tight_bits[(size_t)owner * words];
+    int count = 0;
+    for (int w = 0; w < words; ++w)
+    {
+        count += PopCount(row[w] & list[w]);
+    }
+    return count;
+}
+
+bool MaxCliqueTabuSearch::IsAdjacent(int a, int b)
+{
+    return (adjacency[(size_t)a * words + b / kWordBits] >> (b % kWordBits)) & 1;
+}
+
+vector<int> MaxCliqueTabuSearch::RandomPermutation(int size)
+{
+    vector<int> permutation(size);
+    for (int i = 0; i < size; ++i)
+    {
+        permutation[i] = i;
+    }
+    shuffle(permutation.begin(), permutation.end(), generator);
+    return permutation;
+}
+
+void MaxCliqueTabuSearch::RemoveFromCliqueWithTabu(int vertex)
+{
+    RemoveFromClique(vertex);
+    tabu_remove_stamp[vertex] = ++tabu_remove_count;
+}
+
+void MaxCliqueTabuSearch::InsertToCliqueWithTabu(int vertex)
+{
+    InsertToClique(vertex);
+    tabu_insert_stamp[vertex] = ++tabu_insert_count;
+}
+
+int MaxCliqueTabuSearch::Swap()
+{
+    auto permutation = RandomPermutation(q_border);
+    int swap_1_vertex = -1;
+    int swap_1_candidate;
+    for (int i = 0; i < q_border; ++i)
+    {
+        int vertex = qco[permutation[i]];
+        const vector<int>& swap_candidates = one_tight[vertex];
+        int size = swap_candidates.size();
+        if (size == 0)
+        {
+            continue;
+        }
+        // the lists are searched from a random place
+        int start = GetRandom(0, size - 1);
+        if (adjacent_pairs[vertex] > 0)
+        {
+            int c1 = -1;
+            int c2 = -1;
+            for (int t = 0; c1 < 0; ++t)
+            {
+                int candidate = swap_candidates[(start + t) % size];
+                if (NeighboursInList(candidate, vertex) > 0)
+                {
+                    c1 = candidate;
+                }
+            }
+            for (int t = 0; c2 < 0; ++t)
+            {
+                int candidate = swap_candidates[(start + t) % size];
+                if (IsAdjacent(c1, candidate))
+                {
+                    c2 = candidate;
+                }
+            }
+            RemoveFromClique(vertex);
+            InsertToClique(c1);
+            InsertToClique(c2);
+            return 2;
+        }
+        if (swap_1_vertex == -1 && !IsTabuToInsert(vertex))
+        {
+            for (int t = 0; t < size; ++t)
+            {
+                int swap_candidate = swap_candidates[(start + t) % size];
+                if (!IsTabuToRemove(swap_candidate))
+                {
+                    swap_1_vertex = vertex;
+                    swap_1_candidate = swap_candidate;
+                    break;
+                }
+            }
+        }
+    }
+    if (swap_1_vertex >= 0)
+    {
+        RemoveFromCliqueWithTabu(swap_1_vertex);
+        InsertToCliqueWithTabu(swap_1_candidate);
+        return 1;
+    }
+    return 0;
+}
+
+bool MaxCliqueTabuSearch::Move()
+{
+    if (c_border == q_border)
+        return false;
+    int vertex = qco[GetRandom(q_border, c_border - 1)];
+    InsertToClique(vertex);
+    return true;
+}
+
+void MaxCliqueTabuSearch::FindInitialClique(float randomization)
+{
+    initial_candidates.Reset();
+    while (!initial_candidates.Empty())
+    {
+        int random_index = GetRandom(0, min<int>(randomization * initial_candidates.Size() + (randomization > 0 ? 1 : 0), initial_candidates.Size() - 1));
+        InsertToClique(initial_candidates.Take(random_index));
+    }
+}
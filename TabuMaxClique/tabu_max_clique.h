@@ -0,0 +1,143 @@
+#pragma once
+#include <vector>
+#include <unordered_set>
+#include <string>
+#include <random>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#include "../Common/bit_ops.h"
+#include "../Common/graph_handle.h"
+#include "../Common/ordered_candidates.h"
+#include "../Common/search_profile.h"
+
+// the best clique of a portfolio of tabu searches and the conditions that stop all of them
+struct TabuPortfolio
+{
+    std::mutex best_mutex;
+    std::unordered_set<int> best_clique;
+    std::atomic<bool> stop{ false };
+    // 0 - no target, the portfolio runs until the time limit or the iterations are over
+    int target_size = 0;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point deadline;
+    double time_to_target = -1;
+    // every improvement of the shared clique, in seconds since start
+    std::vector<ProfileEvent> incumbents;
+
+    void Publish(const std::unordered_set<int>& clique);
+
+    bool ShouldStop();
+};
+
+// tabu search for a large clique: vertices are added while they can be, then (1,1) and (1,2) swaps with the 1-tight
+// vertices go on until they run out and a few random clique vertices are removed
+class MaxCliqueTabuSearch
+{
+public:
+    // sizes the search state once, the non-neighbours, the adjacency rows and the initial order come from the
+    // graph and are shared with every other search on it
+    explicit MaxCliqueTabuSearch(const GraphHandle& graph);
+
+    int GetRandom(int a, int b);
+
+    void SetSeed(unsigned new_seed);
+
+    void RunSearch(int iterations);
+
+    // a function to run copies of the search on several threads until one of them finds a clique of
+    // target_size, the wall-clock time limit is over or every copy made its iterations, a target_size of 0 never
+    // stops it. Worker w is seeded with seed + w and shifts the tabu tenure cycle by w, so worker 0 repeats RunSearch.
+    // Returns the wall-clock seconds to reach the target, -1 if it wasn't reached
+    double RunPortfolio(int threads, int iterations, int target_size, double time_limit);
+
+    const std::unordered_set<int>& GetClique();
+
+    // counters of the last run, summed over the workers of a portfolio, incumbents are seconds since it started
+    const TabuProfile& GetProfile();
+
+    bool Check();
+
+    std::string PrintClique();
+
+private:
+    GraphHandle graph;
+    // non-neighbours of every vertex as sorted arrays, they are traversed on every insert and remove
+    const CsrGraph& non_neighbours;
+    // candidates of the initial clique, in last degree with remove order
+    OrderedCandidates initial_candidates;
+    std::unordered_set<int> best_clique;
+    std::vector<int> qco;
+    std::vector<int> index;
+    std::vector<int> tightness;
+    // sum of the clique vertices every vertex is not adjacent to, for a 1-tight vertex it is the clique vertex it misses
+    std::vector<long long> missing_sum;
+    // 1-tight vertices of every clique vertex, they can be swapped with it, and the position of each one in its list
+    std::vector<std::vector<int>> one_tight;
+    std::vector<int> one_tight_position;
+    // adjacency rows and the 1-tight lists as bitsets, a vertex joining or leaving a list changes the number of
+    // adjacent pairs in it by the popcount of its row AND the list. A pair gives a (1,2)-swap
+    int words = 0;
+    const std::vector<Word>& adjacency;
+    std::vector<Word> one_tight_bits;
+    std::vector<int> adjacent_pairs;
+    int q_border;
+    int c_border;
+    unsigned seed = std::mt19937::default_seed;
+    std::mt19937 generator;
+    // a vertex is tabu while it is among the last maxsize vertices put on the list: every list has a counter
+    // of additions and every vertex remembers the counter of its last addition
+    std::vector<long long> tabu_insert_stamp;
+    std::vector<long long> tabu_remove_stamp;
+    long long tabu_insert_count = 0;
+    long long tabu_remove_count = 0;
+    int tabu_insert_maxsize;
+    int tabu_remove_maxsize;
+    TabuProfile profile;
+    ProfileClock run_clock;
+    // set for the workers of RunPortfolio
+    TabuPortfolio* portfolio = nullptr;
+    // the portfolio deadline is checked once per this many steps of the move loop, must be a power of two
+    static const long long kDeadlineCheckSteps = 1024;
+    long long steps = 0;
+    int tenure_shift = 0;
+
+    void ClearClique();
+
+    void ClearTabu();
+
+    bool IsTabuToInsert(int vertex);
+
+    bool IsTabuToRemove(int vertex);
+
+    void SwapVertices(int vertex, int border);
+
+    void InsertToClique(int i);
+
+    void RemoveFromClique(int k);
+
+    // puts the vertex into the 1-tight list of the clique vertex and counts its neighbours there
+    void AddOneTight(int vertex, int owner);
+
+    void RemoveOneTight(int vertex, int owner);
+
+    // the number of the vertex's neighbours in the 1-tight list of the owner
+    int NeighboursInList(int vertex, int owner);
+
+    bool IsAdjacent(int a, int b);
+
+    std::vector<int> RandomPermutation(int size);
+
+    void RemoveFromCliqueWithTabu(int vertex);
+
+    void InsertToCliqueWithTabu(int vertex);
+
+    //a function that searches for swap candidates and looks for possibilities to make 1-2 or 1-1 swaps
+    // it also takes into accout tabu lists
+    int Swap();
+
+    bool Move();
+
+    void FindInitialClique(float randomization);
+};